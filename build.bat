@@ -3,7 +3,7 @@ setlocal
 
 set CXX=g++
 
-set CXXFLAGS=-std=c++17 -O3 -Wall -Wextra
+set CXXFLAGS=-std=c++17 -O3 -pthread -Wall -Wextra
 set OUT=vyne.exe
 
 set SRC_FILES=main.cpp ^
@@ -11,13 +11,22 @@ vyne/vm/vm.cpp ^
 vyne/compiler/codegen/chunk.cpp ^
 vyne/compiler/codegen/codegen.cpp ^
 vyne/compiler/lexer/lexer.cpp ^
+vyne/compiler/lexer/scan.cpp ^
 vyne/compiler/parser/parser.cpp ^
 vyne/compiler/ast/ast.cpp ^
 vyne/compiler/ast/value.cpp ^
+vyne/compiler/ast/flat_program.cpp ^
+vyne/compiler/ast/frame.cpp ^
+vyne/compiler/ast/memo.cpp ^
+vyne/compiler/ast/module_cache.cpp ^
+vyne/compiler/ast/worker_pool.cpp ^
 vyne/modules/vcore/vcore.cpp ^
 vyne/modules/vglib/vglib.cpp ^
 vyne/modules/vmem/vmem.cpp ^
 vyne/modules/vmath/vmath.cpp ^
+vyne/modules/vmath/kernels.cpp ^
+vyne/modules/vmath/matrix.cpp ^
+vyne/modules/registry.cpp ^
 cli/repl.cpp ^
 cli/file_handler.cpp
 
@@ -11,20 +11,29 @@ else
     EXTRA_FLAGS="-O3"
 fi
 
-CXXFLAGS="-std=c++17 $EXTRA_FLAGS -Wall -Wextra -Wpedantic"
+CXXFLAGS="-std=c++17 $EXTRA_FLAGS -pthread -Wall -Wextra -Wpedantic"
 
 SRC_FILES="main.cpp \
 vyne/vm/vm.cpp \
 vyne/compiler/codegen/chunk.cpp \
 vyne/compiler/codegen/codegen.cpp \
 vyne/compiler/lexer/lexer.cpp \
+vyne/compiler/lexer/scan.cpp \
 vyne/compiler/parser/parser.cpp \
 vyne/compiler/ast/ast.cpp \
 vyne/compiler/ast/value.cpp \
+vyne/compiler/ast/flat_program.cpp \
+vyne/compiler/ast/frame.cpp \
+vyne/compiler/ast/memo.cpp \
+vyne/compiler/ast/module_cache.cpp \
+vyne/compiler/ast/worker_pool.cpp \
 vyne/modules/vcore/vcore.cpp \
 vyne/modules/vglib/vglib.cpp \
 vyne/modules/vmem/vmem.cpp \
 vyne/modules/vmath/vmath.cpp \
+vyne/modules/vmath/kernels.cpp \
+vyne/modules/vmath/matrix.cpp \
+vyne/modules/registry.cpp \
 cli/file_handler.cpp \
 cli/repl.cpp"
 
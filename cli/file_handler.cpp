@@ -1,33 +1,42 @@
 #include "file_handler.h"
 
-int runFile(const std::string& filename, SymbolContainer& env, const std::string& mode){
+static bool readScript(const std::string& filename, std::string& content) {
     size_t dotPos = filename.find_last_of(".");
     if (dotPos == std::string::npos || filename.substr(dotPos + 1) != "vy") {
         std::cerr << RED << "Error: File must end in .vy ( .vyne )" << RESET << "\n";
-        return 1;
+        return false;
     }
 
     std::ifstream file(filename);
     if (!file.is_open()) {
         std::cerr << RED << "Could not open file: " << filename << RESET << "\n";
-        return 1;
+        return false;
     }
 
     std::stringstream buffer;
     buffer << file.rdbuf();
-    const std::string content = buffer.str();
+    content = buffer.str();
+    return true;
+}
+
+int runFile(const std::string& filename, SymbolContainer& env, const std::string& mode){
+    std::string content;
+    if (!readScript(filename, content)) return 1;
 
     try {
-        auto tokens = tokenize(content);
-        Parser parser(std::move(tokens));
+        Parser parser(content);
         auto programRoot = parser.parseProgram();
-        std::shared_ptr<ASTNode> rootShared = std::move(programRoot);
+        std::shared_ptr<ASTNode> rootShared = programRoot;
 
         if (mode == "ast") {
+            // parse everything the script uses up front, in parallel
+            if (!parser.imports().empty()) ModuleCache::instance().preload(parser.imports());
+
             std::cout << GREEN << "Executing via AST Interpreter...\n" << RESET;
             auto start = std::chrono::high_resolution_clock::now();
 
-            rootShared->evaluate(env); 
+            FlatProgram flat(*programRoot);
+            flat.run(env);
             
             auto end = std::chrono::high_resolution_clock::now();
             std::chrono::duration<double, std::milli> ms = end - start;
@@ -63,4 +72,62 @@ int runFile(const std::string& filename, SymbolContainer& env, const std::string
     }
 
     return 0;
-}
\ No newline at end of file
+}
+int benchLexer(const std::string& filename) {
+    std::string content;
+    if (!readScript(filename, content)) return 1;
+
+    const double megabytes = content.size() / 1e6;
+    const std::string best = activeScanner().name;
+
+    std::cout << GREEN << "Lexing " << filename << " (" << content.size() << " bytes)\n" << RESET;
+
+    for (const Scanner* scanner : availableScanners()) {
+        selectScanner(scanner->name);
+        size_t count = tokenize(content).size();   // warm-up
+
+        // repeat until the timing is well above clock noise
+        size_t runs = 0;
+        std::chrono::duration<double> elapsed{0};
+        auto start = std::chrono::high_resolution_clock::now();
+        while (runs < 3 || elapsed.count() < 0.5) {
+            count = tokenize(content).size();
+            runs++;
+            elapsed = std::chrono::high_resolution_clock::now() - start;
+        }
+
+        std::cout << "  " << scanner->name << ": " << (megabytes * runs / elapsed.count()) << " MB/s, "
+                  << count << " tokens, " << runs << " runs\n";
+    }
+
+    selectScanner(best);
+    return 0;
+}
+
+int benchParser(const std::string& filename) {
+    std::string content;
+    if (!readScript(filename, content)) return 1;
+
+    const size_t lines = std::count(content.begin(), content.end(), '\n') + 1;
+    std::cout << GREEN << "Parsing " << filename << " (" << lines << " lines)\n" << RESET;
+
+    try {
+        Parser(content).parseProgram();   // warm-up, and surfaces syntax errors once
+
+        size_t runs = 0;
+        std::chrono::duration<double> elapsed{0};
+        auto start = std::chrono::high_resolution_clock::now();
+        while (runs < 3 || elapsed.count() < 0.5) {
+            Parser(content).parseProgram();
+            runs++;
+            elapsed = std::chrono::high_resolution_clock::now() - start;
+        }
+
+        std::cout << "  " << (lines * runs / elapsed.count()) << " lines/s, "
+                  << (elapsed.count() * 1000 / runs) << "ms per parse, " << runs << " runs\n";
+    } catch (const std::exception& e) {
+        std::cerr << RED << "Error: " << e.what() << RESET << "\n";
+        return 1;
+    }
+    return 0;
+}
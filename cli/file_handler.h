@@ -4,11 +4,15 @@
 #include <fstream>
 #include <sstream>
 #include <chrono>
+#include <algorithm>
 
 #include "../vyne/compiler/lexer/lexer.h"
+#include "../vyne/compiler/lexer/scan.h"
 #include "../vyne/compiler/parser/parser.h"
 #include "../vyne/compiler/ast/ast.h"
 #include "../vyne/compiler/ast/value.h"
+#include "../vyne/compiler/ast/flat_program.h"
+#include "../vyne/compiler/ast/module_cache.h"
 #include "../vyne/compiler/codegen/codegen.h"
 #include "../vyne/vm/vm.h"
 
@@ -19,4 +23,10 @@
 #define CYAN    "\033[36m"
 #define BOLD    "\033[1m"
 
-int runFile(const std::string& filename, SymbolContainer& env, const std::string& mode);
\ No newline at end of file
+int runFile(const std::string& filename, SymbolContainer& env, const std::string& mode);
+
+/// Prints the tokenize() throughput of a script in MB/s, once per scanner the CPU supports.
+int benchLexer(const std::string& filename);
+
+/// Prints how many source lines per second the parser (lexing included) gets through.
+int benchParser(const std::string& filename);
\ No newline at end of file
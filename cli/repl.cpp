@@ -15,22 +15,22 @@ void init_REPL(std::string& input, SymbolContainer& env){
             std::cout << YELLOW << "--- Current Symbol env ---" << RESET << "\n";
             bool hasAnyVariables = false;
 
-            for (const auto& [groupName, table] : env) {
+            env.forEach([&](ScopeId scope, const SymbolTable& table) {
                 for (const auto& [varId, val] : table) {
                     hasAnyVariables = true;
                     
                     std::string realName = StringPool::instance().get(varId);
 
-                    if (groupName == "global") {
+                    if (scope == SymbolContainer::GLOBAL) {
                         std::cout << BOLD << realName << RESET << " = ";
                     } else {
-                        std::cout << CYAN << groupName << RESET << "." << BOLD << realName << RESET << " = ";
+                        std::cout << CYAN << env.name(scope) << RESET << "." << BOLD << realName << RESET << " = ";
                     }
 
                     val.print(std::cout);
                     std::cout << "\n";
                 }
-            }
+            });
 
             if (!hasAnyVariables) {
                 std::cout << "(no variables defined)" << "\n";
@@ -40,8 +40,7 @@ void init_REPL(std::string& input, SymbolContainer& env){
         }
 
         try {
-            auto tokens = tokenize(input);
-            Parser parser(std::move(tokens));
+            Parser parser(input);
 
             auto root = parser.parseProgram();
             if (root) {
@@ -3,7 +3,6 @@
 
 int main(int argc, char* argv[]) {
     SymbolContainer env;
-    env["global"] = {};
 
     if (argc == 3) {
         std::string flag = argv[1];
@@ -13,6 +12,10 @@ int main(int argc, char* argv[]) {
             runFile(filename, env, "ast");
         } else if (flag == "--bytecode") {
             runFile(filename, env, "bytecode");
+        } else if (flag == "--bench-lexer") {
+            return benchLexer(filename);
+        } else if (flag == "--bench-parser") {
+            return benchParser(filename);
         } else {
             std::cerr << "Unknown flag: " << flag << "\n";
             return 1;
@@ -0,0 +1,35 @@
+# return, break and continue from nested blocks inside functions and loops
+sub firstOddOver(limit) {
+    i = 0;
+    while (i < 100) {
+        i = i + 1;
+        if (i % 2 == 0) { continue; }
+        if (i > limit) { return i; }
+    }
+    return -1;
+}
+
+out(firstOddOver(10));   # 11
+out(firstOddOver(1000)); # -1
+
+j = 0;
+while (1) {
+    j = j + 1;
+    if (j == 5) { break; }
+}
+out(j); # 5
+
+sub findTimesTen(arr) {
+    through x :: arr -> loop { if (x == 3) { return x * 10; } };
+    return 0;
+}
+out(findTimesTen([1, 2, 3, 4])); # 30
+
+sub lastValue(a) { a + 1; }
+out(lastValue(4)); # 5
+
+sub fib(n) {
+    if (n < 2) { return n; }
+    return fib(n - 1) + fib(n - 2);
+}
+out(fib(15)); # 610
@@ -0,0 +1,51 @@
+# Arrays have value semantics, copies only clone when one side is modified
+original = [1, 2, 3];
+copy = original;
+copy.push(4);
+out(original); # [1, 2, 3]
+out(copy);     # [1, 2, 3, 4]
+
+merged = original + [9];
+out(original); # left operand is untouched by +
+
+grid = [[1], [2]];
+snapshot = grid;
+grid[0].push(5);
+out(grid);     # [[1, 5], [2]]
+out(snapshot); # [[1], [2]]
+
+# uniquely owned arrays are appended in place
+history = [];
+i = 0;
+while i < 10000 {
+    history = history + [i];
+    i = i + 1;
+}
+out(history.size());
+
+# operands are read in place, unless a call on the right could change them first
+level = 1;
+sub raise() { level = 50; return 1; }
+out(level + raise()); # 2
+
+pairs = [{"k": 1}, {"k": 2}];
+out(pairs[1].get("k")); # 2
+base = [1];
+grown = base + [2];
+out(base);  # [1]
+out(grown); # [1, 2]
+
+# storing a container in itself stores a copy, so no array or map can reach
+# itself and dropping the last name frees it without a cycle collector
+a = [1, 2];
+a.push(a);
+out(a);        # [1, 2, [1, 2]]
+
+m = {"id": 1};
+m.set("k", m);
+out(m);        # {"id": 1, "k": {"id": 1}}
+
+x = [0];
+x.push([x]);
+x.push(3);
+out(x);        # [0, [[0]], 3]
@@ -0,0 +1,41 @@
+# Locals of a sub live in the call's frame, every call gets its own.
+sub sum_to(n) {
+    if (n == 0) { return 0; }
+    rest = sum_to(n - 1);
+    return n + rest;   # rest/n must not be clobbered by the inner calls
+}
+out(sum_to(10)); # 55
+
+limit = 3;
+sub count_up() {
+    out(limit);     # global 3, read through until assigned
+    steps = 0;
+    while (steps < limit) { steps++; }
+    limit = 7;      # local from here on
+    out(limit);     # 7
+    return steps;
+}
+out(count_up()); # 3
+out(limit);      # 3
+
+sub pair(a, b) {
+    a = a * 10;
+    return a + b;
+}
+out(pair(1, 2)); # 12
+out(pair(3, 4)); # 34
+
+module Shapes;
+sub::Shapes area(w, h) {
+    size = w * h;
+    return size;
+}
+out(Shapes.area(3, 4)); # 12
+
+# a `through` loop in the body keeps the sub on a call scope
+sub total(items) {
+    acc = 0;
+    through item :: items -> loop { acc = acc + item; };
+    return acc;
+}
+out(total([1, 2, 3])); # 6
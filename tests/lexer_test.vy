@@ -0,0 +1,26 @@
+# Identifiers that start like a keyword are still identifiers.
+iffy = 1;
+subtotal = 2;
+returned = 3;
+outer = iffy + subtotal + returned;
+out(outer); # 6
+
+# Escapes are resolved when the literal is parsed.
+quote = "say \"hi\"\tnow";
+out(quote);
+out(sizeof("a\nb")); # 3
+
+# Numbers stop before a range's '..'.
+out(1..3);   # [1, 2, 3]
+out(2.5 + 0.25); # 2.75
+
+# Long runs go through the vector scanners (16/32 bytes per step).
+a_rather_long_identifier_name_that_spans_more_than_one_block = 40;                                        # and a trailing comment that runs well past the block width
+out(a_rather_long_identifier_name_that_spans_more_than_one_block + 2); # 42
+out("a string literal long enough to cross a 32 byte block, with an escaped \"quote\" in the middle");
+
+# A statement starting with an index makes the parser look past the whole
+# bracket for a '=', well beyond its initial lookahead ring.
+cells = [0, 9, 0];
+cells[(1 + 1) * (0 + 0) + (1 - 1) + (2 - 2) + (3 - 3) + 1];
+out(cells[(1 + 1) * (0 + 0) + (1 - 1) + (2 - 2) + (3 - 3) + 1]); # 9
@@ -0,0 +1,27 @@
+# Maps are hash tables keyed by value, written as { key: value }
+ages = {"ann": 31, "bob": 42};
+ages.set("cid", 27);
+ages.set("ann", 32);
+
+out(ages);              # {"ann": 32, "bob": 42, "cid": 27}
+out(ages["bob"]);       # 42
+out(ages.get("zed", 0)); # fallback for missing keys
+out(ages.has("cid"));
+out(ages.keys());
+
+ages.remove("bob");
+out(ages.size());       # 2
+
+# joining two datasets by key is a single pass over each
+orders = [["ann", 10], ["cid", 5], ["ann", 7]];
+totals = {};
+through order :: orders -> loop {
+    name = order[0];
+    totals.set(name, totals.get(name, 0) + order[1]);
+};
+out(totals);            # {"ann": 17, "cid": 5}
+
+# maps are values, copies don't see later changes
+snapshot = totals;
+totals.set("dan", 1);
+out(snapshot.has("dan"));
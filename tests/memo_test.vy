@@ -0,0 +1,42 @@
+module vmem;
+
+# `memo sub` caches results by argument, the exponential fib becomes linear.
+memo sub fib(n) {
+    if (n < 2) { return n; }
+    return fib(n - 1) + fib(n - 2);
+}
+out(fib(60)); # 1.54801e+12
+
+stats = vmem.memo_stats();
+out(stats.get("misses")); # 61, one run per distinct n
+out(stats.get("hits"));   # 58
+
+# pure helpers may be called, loops over ranges are fine
+sub square(x) { return x * x; }
+memo sub sum_squares(n) {
+    total = 0;
+    through i :: 1..n -> loop { total = total + square(i); };
+    return total;
+}
+out(sum_squares(10)); # 385
+out(sum_squares(10)); # 385, from the cache
+
+# redefining a sub a memo sub calls drops the results computed with the old one
+sub g(n) { return n * 2; }
+memo sub h(n) { return g(n); }
+out(h(3)); # 6
+sub g(n) { return n * 3; }
+out(h(3)); # 9
+
+# `memo` only marks a sub, it is still an ordinary name elsewhere
+memo = 5;
+out(memo); # 5
+
+# a name only some paths assign still reads the enclosing scope on the others,
+# so caching f would keep returning the result for the old t
+t = 10;
+memo sub f(n) {
+    if (n > 100) { t = 1; }
+    return t + n;
+}
+out(f(1)); # Runtime Error: Cannot memo 'f', it reads or changes state outside its own locals
@@ -0,0 +1,27 @@
+# Native modules are built once per process, every `module` statement after that only binds them.
+sub hypotenuse(a, b) {
+    module vmath;
+    return vmath.sqrt(a * a + b * b);
+}
+
+total = 0;
+i = 0;
+while (i < 100) {
+    total = total + hypotenuse(3, 4);
+    i++;
+}
+out(total); # 500
+
+module vmath;
+out(vmath.floor(vmath.pi * 100)); # 314
+out(vmath.max(2, 7)); # 7
+out(vmath.clamp(5, 10, 1)); # 5
+out(vmath.atan2(0, 0 - 1) == vmath.pi); # 1
+out(vmath.version); # "v0.0.1-alpha"
+
+module vcore;
+out(vcore.clamp(15, 0, 10)); # 10
+out(vcore.engine); # "Vyne Native"
+
+module vmem;
+out(vmem.memo_stats().size()); # 3
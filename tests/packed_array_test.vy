@@ -0,0 +1,16 @@
+# Numeric arrays are stored packed until a non-number shows up
+samples = 1..10;
+samples.reverse();
+samples.sort();
+out(samples);
+
+samples.push("done"); # spills into generic storage
+out(samples);
+
+samples.delete("done");
+samples.sort(); # packs again before sorting
+out(samples[9]);
+
+filled = [];
+filled.place_all(0.5, 4);
+out(through filled -> collect { _ * 2 });
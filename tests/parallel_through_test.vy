@@ -0,0 +1,56 @@
+# `parallel` spreads a collect, filter or every over the worker threads,
+# results still come back in the order of the input.
+sub square(x) { return x * x; }
+memo sub fib(n) {
+    if (n < 2) { return n; }
+    return fib(n - 1) + fib(n - 2);
+}
+
+squares = through 1..8 -> parallel collect { square(_) };
+out(squares); # [1, 4, 9, 16, 25, 36, 49, 64]
+
+evens = through 1..20 -> parallel filter { _ % 2 == 0 };
+out(evens); # [2, 4, 6, 8, 10, 12, 14, 16, 18, 20]
+
+# the body only reads the enclosing scope, what it assigns stays per element
+offset = 100;
+shifted = through n :: [1, 2, 3] -> parallel collect {
+    doubled = n * 2;
+    doubled + offset
+};
+out(shifted); # [102, 104, 106]
+
+fibs = through 20..25 -> parallel collect { fib(_) };
+out(fibs); # [6765, 10946, 17711, 28657, 46368, 75025]
+
+# arrays built inside the body belong to that element
+rows = through n :: 1..4 -> parallel collect {
+    row = [];
+    through i :: 1..n -> loop { row.push(i * n); };
+    row
+};
+out(rows); # [[1], [2, 4], [3, 6, 9], [4, 8, 12, 16]]
+
+words = ["pear", "fig", "banana", "kiwi"];
+out(through words -> parallel filter { _ != "fig" }); # ["pear", "banana", "kiwi"]
+
+# break keeps what came before it, continue skips one element
+out(through 1..10 -> parallel collect { if (_ == 4) { break; } _ }); # [1, 2, 3]
+out(through 1..6 -> parallel collect { if (_ % 3 == 0) { continue; } _ }); # [1, 2, 4, 5]
+out(through 1..5 -> parallel every { _ * 10 }); # 50
+
+big = through 1..10000 -> parallel collect { _ * 2 };
+out(big.size()); # 10000
+total = 0;
+through big -> loop { total = total + _; };
+out(total / 10000); # 10001, the sum 100010000 prints in exponent form
+
+# a body that updates a name further up the scope chain has to see each
+# update in turn, so it can't run in parallel
+acc = 100;
+group h {
+    s = through 1..4 -> collect { acc = acc + _; acc };
+    out(s); # [101, 103, 106, 110]
+    r = through 1..4 -> parallel collect { acc = acc + _; acc };
+    out(r); # Runtime Error: Cannot run 'through' in parallel, its body assigns 'acc', a variable of the enclosing scope
+};
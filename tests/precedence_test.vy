@@ -0,0 +1,11 @@
+# Binary operators, loosest to tightest:
+#   ..  ||  &&  == !=  < > <= >=  + - // %  * / **
+out(1 + 2 * 3);        # 7
+out(2 * 3 ** 2);       # 36, '**' shares the level of '*' and groups left
+out(10 - 4 - 3);       # 3
+out(1 + 1 == 2);       # 1
+out(1 < 2 == 2 > 1);   # 1
+out(0 || 1 && 0);      # 0
+out(1 .. 1 + 2);       # [1, 2, 3]
+out(-2 * 3);           # -6
+out(!0 && 1);          # 1
@@ -0,0 +1,42 @@
+# Variable references remember where they resolved, these check that the
+# remembered storage follows shadowing, groups and dismiss correctly.
+x = 1;
+sub shadow() {
+    out(x);   # global 1
+    x = 5;    # creates a local
+    out(x);   # local 5
+    return x;
+}
+out(shadow()); # 5
+out(shadow()); # 5
+out(x);        # still 1
+
+group tracker {
+    count = 0;
+    i = 0;
+    while (i < 3) { count = count + 1; i++; }
+};
+out(tracker.count); # 3
+out(tracker.i);     # 3
+
+y = 10;
+k = 0;
+while (k < 3) {
+    out(y); # 10, 10, 20
+    if (k == 1) { dismiss y; y = 20; }
+    k++;
+}
+
+arr = [1, 2, 3];
+j = 0;
+while (j < 3) { arr.push(arr[j] * 2); j++; }
+out(arr); # [1, 2, 3, 2, 4, 6]
+
+# nested groups see the variables of the groups around them
+group outer {
+    base = 4;
+    group inner {
+        twice = base * 2;
+    };
+};
+out(outer.inner.twice); # 8
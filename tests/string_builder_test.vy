@@ -0,0 +1,12 @@
+# Repeated concatenation builds a rope, flattened only when the text is read
+report = "";
+i = 0;
+while i < 20000 {
+    report = report + "line " + string(i) + "\n";
+    i = i + 1;
+}
+out(report == report + "");
+
+greeting = "Hello, " + "World";
+out(greeting);
+out(greeting == "Hello, World");
@@ -0,0 +1,20 @@
+# `return f(...)` reuses the caller's frame, deep tail recursion runs in constant stack.
+sub count(n, acc) {
+    if (n == 0) { return acc; }
+    return count(n - 1, acc + 1);
+}
+out(count(200000, 0)); # 200000
+
+sub is_even(n) {
+    if (n == 0) { return true; }
+    return is_odd(n - 1);
+}
+sub is_odd(n) {
+    if (n == 0) { return false; }
+    return is_even(n - 1);
+}
+out(is_even(100001)); # false
+
+module Steps;
+sub::Steps run(n) { return count(n, 0); }
+out(Steps.run(50000)); # 50000
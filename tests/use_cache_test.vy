@@ -0,0 +1,12 @@
+# The first `use` of a file evaluates it, later ones bind to the cached exports.
+use "./tests/deploy_test.vy";
+
+spins = 0;
+while (spins < 3) {
+    use "./tests/deploy_test.vy";
+    spins++;
+}
+out(math.add(2, 3)); # 5
+
+use "./tests/deploy_test.vy" as lib;
+out(lib.math.add(4, 4)); # 8
@@ -0,0 +1,30 @@
+# Whole-array vmath functions, one native call per array instead of per element
+module vmath;
+
+a = [1, 2, 3, 4, 5, 6, 7, 8, 9];
+b = [9, 8, 7, 6, 5, 4, 3, 2, 1];
+
+out(vmath.add(a, b));       # [10, 10, 10, 10, 10, 10, 10, 10, 10]
+out(vmath.subtract(a, b));  # [-8, -6, -4, -2, 0, 2, 4, 6, 8]
+out(vmath.mul(a, b));       # [9, 16, 21, 24, 25, 24, 21, 16, 9]
+out(vmath.scale(a, 0.5));   # [0.5, 1, 1.5, 2, 2.5, 3, 3.5, 4, 4.5]
+
+out(vmath.sum(a));          # 45
+out(vmath.dot(a, b));       # 165
+out(vmath.min(a));          # 1
+out(vmath.max(b));          # 9
+out(vmath.min(3, 4));       # 3, two numbers still work
+
+out(vmath.map_abs(vmath.subtract(a, b)));  # [8, 6, 4, 2, 0, 2, 4, 6, 8]
+out(vmath.map_sqrt([4, 9, 16]));            # [2, 3, 4]
+out(vmath.map_sin([0]));                    # [0]
+out(vmath.map_log([1, vmath.e]));           # [0, 1]
+
+# arrays that aren't packed are read element by element
+mixed = [1, "two", 3];
+mixed.pop();
+mixed.pop();
+mixed.push(5);
+out(vmath.sum(mixed));      # 6
+
+out(vmath.sum([]));         # 0
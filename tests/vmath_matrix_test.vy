@@ -0,0 +1,51 @@
+# Matrix values in vmath: contiguous rows of numbers, built once, every operation returns a new one
+module vmath;
+
+a = vmath.matrix([[1, 2, 3], [4, 5, 6]]);
+b = vmath.matrix([[7, 8], [9, 10], [11, 12]]);
+
+out(a);                                 # matrix([[1, 2, 3], [4, 5, 6]])
+out(vmath.shape(a));                    # [2, 3]
+out(vmath.matmul(a, b));                # matrix([[58, 64], [139, 154]])
+out(vmath.transpose(a));                # matrix([[1, 4], [2, 5], [3, 6]])
+out(vmath.to_array(vmath.transpose(b)));  # [[7, 9, 11], [8, 10, 12]]
+
+out(vmath.add(a, a));                   # matrix([[2, 4, 6], [8, 10, 12]])
+out(vmath.subtract(a, a));              # matrix([[0, 0, 0], [0, 0, 0]])
+out(vmath.mul(a, a));                   # matrix([[1, 4, 9], [16, 25, 36]])
+out(vmath.scale(a, 2));                 # matrix([[2, 4, 6], [8, 10, 12]])
+
+i :: Matrix = vmath.identity(3);
+out(vmath.matmul(b, vmath.identity(2)) == b);  # 1
+
+# 2x + y = 5, x + 3y = 10
+m = vmath.matrix([[2, 1], [1, 3]]);
+out(vmath.solve(m, [5, 10]));           # [1, 3]
+out(vmath.solve(m, vmath.identity(2))); # the inverse: matrix([[0.6, -0.2], [-0.2, 0.4]])
+
+# bigger than one block, checked against the identity
+n = 70;
+rows = [];
+r = 0;
+while (r < n) {
+    row = [];
+    c = 0;
+    while (c < n) {
+        row.push((r * 7 + c * 3) % 11);
+        c = c + 1;
+    }
+    rows.push(row);
+    r = r + 1;
+}
+big = vmath.matrix(rows);
+out(vmath.matmul(big, vmath.identity(n)) == big);                     # 1
+out(vmath.transpose(vmath.transpose(big)) == big);                    # 1
+
+# row 0 of big * big is row 0 of big dotted with each column of big
+product = vmath.to_array(vmath.matmul(big, big));
+columns = vmath.to_array(vmath.transpose(big));
+rowsOfBig = vmath.to_array(big);
+first = rowsOfBig[0];
+top = product[0];
+out(top[5] == vmath.dot(first, columns[5]));     # 1
+out(top[69] == vmath.dot(first, columns[69]));   # 1
@@ -0,0 +1,102 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+#include <utility>
+#include <type_traits>
+
+/**
+ * @brief Fixed-size view over an array that lives in an AstArena.
+ * * @details Child lists of AST nodes are built in a scratch std::vector while
+ * parsing and then copied once, at their final size, into the arena.
+ */
+template <typename T>
+class ArenaList {
+    T* items = nullptr;
+    size_t count = 0;
+
+public:
+    ArenaList() = default;
+    ArenaList(T* data, size_t n) : items(data), count(n) {}
+
+    T* begin()  const { return items; }
+    T* end()    const { return items + count; }
+    size_t size() const { return count; }
+    bool empty()  const { return count == 0; }
+
+    T& operator[](size_t index) const { return items[index]; }
+    T& back() const { return items[count - 1]; }
+};
+
+/**
+ * @brief Bump-pointer arena that owns every node of one parsed program.
+ * * @details Nodes are placement-constructed into large blocks and point at
+ * each other with raw pointers. The arena is released in one go: destructors
+ * run in reverse order of construction (only for types that have one), then
+ * the blocks are freed. Whoever keeps a node past the parse (the program
+ * root, function values) holds a shared_ptr to the arena instead.
+ */
+class AstArena : public std::enable_shared_from_this<AstArena> {
+    struct Finalizer {
+        void* object;
+        void (*destroy)(void*);
+    };
+
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+    std::vector<std::unique_ptr<std::byte[]>> blocks;
+    std::vector<Finalizer> finalizers;
+    std::byte* cursor = nullptr;
+    std::byte* limit = nullptr;
+    size_t used = 0;
+
+    void* allocate(size_t bytes, size_t align) {
+        uintptr_t at = (reinterpret_cast<uintptr_t>(cursor) + align - 1) & ~(uintptr_t)(align - 1);
+
+        if (!cursor || at + bytes > reinterpret_cast<uintptr_t>(limit)) {
+            size_t blockSize = bytes + align > BLOCK_SIZE ? bytes + align : BLOCK_SIZE;
+            blocks.emplace_back(new std::byte[blockSize]);
+            cursor = blocks.back().get();
+            limit = cursor + blockSize;
+            at = (reinterpret_cast<uintptr_t>(cursor) + align - 1) & ~(uintptr_t)(align - 1);
+        }
+
+        cursor = reinterpret_cast<std::byte*>(at + bytes);
+        used += bytes;
+        return reinterpret_cast<void*>(at);
+    }
+
+public:
+    AstArena() = default;
+    AstArena(const AstArena&) = delete;
+    AstArena& operator=(const AstArena&) = delete;
+
+    ~AstArena() {
+        for (auto it = finalizers.rbegin(); it != finalizers.rend(); ++it) it->destroy(it->object);
+    }
+
+    template <typename T, typename... Args>
+    T* make(Args&&... args) {
+        T* obj = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            finalizers.push_back({obj, [](void* p) { static_cast<T*>(p)->~T(); }});
+        }
+        return obj;
+    }
+
+    template <typename T>
+    ArenaList<T> list(const std::vector<T>& items) {
+        static_assert(std::is_trivially_copyable_v<T>, "arena lists hold pointers or plain pairs");
+        if (items.empty()) return {};
+
+        T* data = static_cast<T*>(allocate(sizeof(T) * items.size(), alignof(T)));
+        std::uninitialized_copy(items.begin(), items.end(), data);
+        return ArenaList<T>(data, items.size());
+    }
+
+    /// Bytes handed out so far (excluding block slack).
+    size_t bytesUsed() const { return used; }
+};
@@ -1,20 +1,108 @@
 #include "ast.h"
 
-#include "../../modules/vcore/vcore.h"
-#include "../../modules/vglib/vglib.h"
-#include "../../modules/vmem/vmem.h"
-#include "../../modules/vmath/vmath.h"
+#include "../../modules/registry.h"
 
 #include "../parser/parser.h"
 #include "../lexer/lexer.h"
+#include "flat_program.h"
+#include "module_cache.h"
+#include "worker_pool.h"
 
-Value ProgramNode::evaluate(SymbolContainer& env, const std::string& currentGroup) const {
+#include <atomic>
+#include <exception>
+
+SymbolContainer::SymbolContainer() {
+    allocate(NONE, StringPool::instance().intern("global"));
+}
+
+ScopeId SymbolContainer::allocate(ScopeId parent, uint32_t nameId) {
+    ScopeId id;
+    if (!freeIds.empty()) {
+        id = freeIds.back();
+        freeIds.pop_back();
+    } else {
+        id = static_cast<ScopeId>(scopes.size());
+        scopes.emplace_back();
+    }
+
+    Scope& scope = scopes[id];
+    scope.nameId = nameId;
+    scope.parent = parent;
+    scope.live = true;
+    return id;
+}
+
+void SymbolContainer::release(ScopeId id) {
+    Scope& scope = scopes[id];
+    for (const auto& [nameId, childId] : scope.children) release(childId);
+
+    scope.children.clear();
+    scope.vars.clear();
+    scope.live = false;
+    freeIds.emplace_back(id);
+
+    // the id will come back as a different scope, references resolved through it are stale
+    SymbolTable::invalidate();
+}
+
+ScopeId SymbolContainer::child(ScopeId parent, uint32_t nameId) {
+    ScopeId existing = findChild(parent, nameId);
+    if (existing != NONE) return existing;
+
+    ScopeId id = allocate(parent, nameId);
+    scopes[parent].children[nameId] = id;
+    return id;
+}
+
+ScopeId SymbolContainer::findChild(ScopeId parent, uint32_t nameId) const {
+    const auto& children = scopes[parent].children;
+    auto it = children.find(nameId);
+    return it == children.end() ? NONE : it->second;
+}
+
+ScopeId SymbolContainer::findPath(const std::vector<uint32_t>& path) const {
+    ScopeId at = GLOBAL;
+    for (uint32_t segment : path) {
+        at = findChild(at, segment);
+        if (at == NONE) return NONE;
+    }
+    return at;
+}
+
+ScopeId SymbolContainer::makePath(const std::vector<uint32_t>& path) {
+    ScopeId at = GLOBAL;
+    for (uint32_t segment : path) at = child(at, segment);
+    return at;
+}
+
+bool SymbolContainer::drop(ScopeId parent, uint32_t nameId) {
+    ScopeId id = findChild(parent, nameId);
+    if (id == NONE) return false;
+
+    scopes[parent].children.erase(nameId);
+    release(id);
+    return true;
+}
+
+std::string SymbolContainer::name(ScopeId id) const {
+    std::string path = StringPool::instance().get(scopes[id].nameId);
+    for (ScopeId at = scopes[id].parent; at != NONE; at = scopes[at].parent) {
+        path = StringPool::instance().get(scopes[at].nameId) + "." + path;
+    }
+    return path;
+}
+
+Value ProgramNode::evaluate(SymbolContainer& env, ScopeId currentGroup) const {
     Value lastValue;
-    for (const auto& statement : statements) lastValue = statement->evaluate(env, currentGroup);
+    for (const auto& statement : statements) {
+        // release the previous result first so it doesn't pin shared array storage
+        lastValue = Value();
+        lastValue = statement->evaluate(env, currentGroup);
+    }
     return lastValue; 
 }
 
-Value NumberNode::evaluate(SymbolContainer& env, const std::string& currentGroup) const {
+Value NumberNode::evaluate(SymbolContainer& env, ScopeId currentGroup) const {
     return Value(value);
 }
 
@@ -23,33 +111,57 @@ Value NumberNode::evaluate(SymbolContainer& env, const std::string& currentGroup
  * * @details Performs a scoped lookup:
  * 1. Checks the specific group (if provided, e.g., tracker.lineCount).
  * 2. Checks the current local group.
- * 3. Falls back to the "global" group if not found locally.
+ * 3. Falls back to the enclosing scopes, up to global, if not found locally.
  * @see AssignmentNode::evaluate
  * * @throw std::runtime_error If the variable cannot be found in any accessible scope.
  * @return Value The stored value of the variable.
  */
 
-Value VariableNode::evaluate(SymbolContainer& env, const std::string& currentGroup) const {
-    std::string targetGroup = specificGroup.empty() ? currentGroup : "global";
-    if (!specificGroup.empty()) {
-        for (const auto& g : specificGroup) targetGroup += "." + g;
-    }
+Value VariableNode::evaluate(SymbolContainer& env, ScopeId currentGroup) const {
+    Value unused;
+    return *evaluateRef(env, currentGroup, unused);
+}
+
+const Value* VariableNode::evaluateRef(SymbolContainer& env, ScopeId currentGroup, Value&) const {
+    if (const Value* val = resolve(env, currentGroup)) return val;
+
+    throw std::runtime_error("Runtime Error: Variable '" + originalName + "' not found [ line " + std::to_string(lineNumber) + " ]");
+}
 
-    auto groupIt = env.find(targetGroup);
-    if (groupIt != env.end()) {
-        auto varIt = groupIt->second.find(nameId);
-        if (varIt != groupIt->second.end()) return varIt->second;
+/**
+ * @brief Resolves the reference to its storage through the node's VariableSlot.
+ * * @details The qualifier (`tracker.count`) is interned once at parse time and
+ * followed down from global by id. The slot is reused until the scope or the
+ * shape of the tables changes, so repeated reads in a loop skip the lookups.
+ */
+
+Value* VariableNode::resolve(SymbolContainer& env, ScopeId currentGroup) const {
+    if (frameSlot != FrameLayout::NO_SLOT) {
+        Local& local = env.frames().base()[frameSlot];
+        if (local.bound) return &local.value;
     }
+    return env.lookup(slot, specificGroup.empty() ? currentGroup : env.findPath(pathIds), nameId);
+}
 
-    if (targetGroup != "global") {
-        auto globalIt = env.find("global");
-        if (globalIt != env.end()) {
-            auto varIt = globalIt->second.find(nameId);
-            if (varIt != globalIt->second.end()) return varIt->second;
-        }
+Value* VariableNode::resolveLocal(SymbolContainer& env, ScopeId currentGroup) const {
+    if (!specificGroup.empty()) return nullptr;
+
+    if (frameSlot != FrameLayout::NO_SLOT) {
+        Local& local = env.frames().base()[frameSlot];
+        return local.bound ? &local.value : nullptr;
     }
 
-    throw std::runtime_error("Runtime Error: Variable '" + originalName + "' not found [ line " + std::to_string(lineNumber) + " ]");
+    return env.lookupIn(slot, currentGroup, nameId);
+}
+
+void VariableNode::store(SymbolContainer& env, ScopeId currentGroup, Value val) const {
+    if (frameSlot != FrameLayout::NO_SLOT) {
+        Local& local = env.frames().base()[frameSlot];
+        local.value = std::move(val);
+        local.bound = true;
+        return;
+    }
+    env[currentGroup][nameId] = std::move(val);
 }
 
 /**
@@ -59,9 +171,53 @@ Value VariableNode::evaluate(SymbolContainer& env, const std::string& currentGro
  * * @return Value The value being assigned (allows for chained assignments like a = b = 1).
  */
 
-Value AssignmentNode::evaluate(SymbolContainer& env,     const std::string& currentGroup) const {
-    Value val = rhs->evaluate(env, currentGroup);
+/**
+ * @brief Detects `name = name + expr` so the append can happen in place.
+ * @return const BinOpNode* The `+` node on the right-hand side, or nullptr.
+ */
+
+const BinOpNode* AssignmentNode::detectSelfAppend() const {
+    if (indexExpr || isConstant || expectedType != VType::Unknown) return nullptr;
+    if (!rhs || rhs->type() != NodeType::BINARY_OP) return nullptr;
+
+    auto* bin = static_cast<const BinOpNode*>(rhs);
+    if (bin->getOp() != VTokenType::Add || bin->getLeft()->type() != NodeType::VARIABLE) return nullptr;
+
+    auto* var = static_cast<const VariableNode*>(bin->getLeft());
+    if (var->getNameId() != identifierId || var->getScope() != scopePath) return nullptr;
+
+    return bin;
+}
+
+Value AssignmentNode::evaluate(SymbolContainer& env,     ScopeId currentGroup) const {
+    Value val;
+
+    // `a = a + [x]` appends into a's storage directly when a owns it uniquely,
+    // instead of copying the whole array into a temporary first.
+    if (selfAppend) {
+        Value* stored = existing(env, currentGroup);
+        if (stored && stored->getType() == Value::ARRAY && !stored->isReadOnly) {
+            Value r = selfAppend->getRight()->evaluate(env, currentGroup);
+
+            // the right-hand side may have changed the tables, resolve again
+            stored = existing(env, currentGroup);
+            if (stored && stored->getType() == Value::ARRAY && r.getType() == Value::ARRAY) {
+                stored->editArray().append(r.asArray());
+                return *stored;
+            }
+
+            val = selfAppend->apply(stored ? *stored : selfAppend->getLeft()->evaluate(env, currentGroup), r);
+        } else {
+            val = rhs->evaluate(env, currentGroup);
+        }
+    } else {
+        val = rhs->evaluate(env, currentGroup);
+    }
+
+    return assign(env, currentGroup, std::move(val));
+}
 
+Value AssignmentNode::assign(SymbolContainer& env, ScopeId currentGroup, Value val) const {
     if (expectedType != VType::Unknown) {
         const std::string& expectedName = VTypeToString(expectedType);
         const std::string& actualName = val.getTypeName(); 
@@ -77,30 +233,26 @@ Value AssignmentNode::evaluate(SymbolContainer& env,     const std::string& curr
         val.setReadOnly();
     }
 
-    std::string targetGroup = resolvePath(scopePath, currentGroup);
-    auto& table = env[targetGroup];
-
-    auto it_existing = table.find(identifierId); 
+    Value* stored = existing(env, currentGroup);
 
-    if (it_existing != table.end()) {
-        int existingType = it_existing->second.getType();
+    if (stored) {
+        int existingType = stored->getType();
         int newType = val.getType();
 
         if (existingType != 0 && existingType != newType) {
             throw std::runtime_error("Type Error: Cannot assign type " + val.getTypeName() + 
                                     " to variable '" + originalName + 
-                                    "' defined as " + it_existing->second.getTypeName() + 
+                                    "' defined as " + stored->getTypeName() + 
                                     " [ line " + std::to_string(lineNumber) + " ]");
         }
     }
 
     if (indexExpr) {
-        auto it = table.find(identifierId);
-        if (it == table.end()) {
+        if (!stored) {
             throw std::runtime_error("Runtime Error: Array '" + originalName + "' not found [ line " + std::to_string(lineNumber) + " ]");
         }
 
-        Value& arrayVal = it->second; 
+        Value& arrayVal = *stored; 
         
         if (arrayVal.getType() != Value::ARRAY) {
             throw std::runtime_error("Runtime Error: Cannot index into non-array '" + originalName + "' [ line " + std::to_string(lineNumber) + " ]");
@@ -109,9 +261,8 @@ Value AssignmentNode::evaluate(SymbolContainer& env,     const std::string& curr
         Value idxValue = indexExpr->evaluate(env, currentGroup);
         size_t idx = static_cast<size_t>(idxValue.asNumber());
 
-        auto& vec = arrayVal.asList();
-        if (idx < vec.size()) {
-            vec[idx] = val;
+        if (idx < arrayVal.asArray().size()) {
+            arrayVal.editArray().set(idx, val);
         } else {
             throw std::runtime_error("Runtime Error: Index out of bounds [ line " + std::to_string(lineNumber) + " ]");
         }
@@ -119,17 +270,39 @@ Value AssignmentNode::evaluate(SymbolContainer& env,     const std::string& curr
         return val;
     }
 
-    auto it = table.find(identifierId);
-    if (it != table.end() && it->second.isReadOnly) {
+    if (stored && stored->isReadOnly) {
         throw std::runtime_error("Runtime Error: Cannot reassign read-only '" + originalName + "' [ line " + std::to_string(lineNumber) + " ]");
     }
 
-    table[identifierId] = val; 
+    if (stored) {
+        *stored = val;
+    } else if (frameSlot != FrameLayout::NO_SLOT) {
+        Local& local = env.frames().base()[frameSlot];
+        local.value = val;
+        local.bound = true;
+    } else {
+        env[targetGroup(env, currentGroup)][identifierId] = val;
+    }
     return val;
 }
 
-Value GroupNode::evaluate(SymbolContainer& env, const std::string& currentGroup) const {
-    std::string nextGroup = currentGroup + "." + groupName;
+/**
+ * @brief The current storage of the assigned variable in its target group, or nullptr.
+ * * @details Globals seen through the fallback don't count: assigning inside a
+ * group or call creates a local, exactly as before.
+ */
+
+Value* AssignmentNode::existing(SymbolContainer& env, ScopeId currentGroup) const {
+    if (frameSlot != FrameLayout::NO_SLOT) {
+        Local& local = env.frames().base()[frameSlot];
+        return local.bound ? &local.value : nullptr;
+    }
+
+    return env.lookupIn(slot, targetGroup(env, currentGroup), identifierId);
+}
+
+Value GroupNode::evaluate(SymbolContainer& env, ScopeId currentGroup) const {
+    ScopeId nextGroup = env.child(currentGroup, groupId);
     for (const auto& stmt : statements) {
         stmt->evaluate(env, nextGroup);
     }
@@ -142,13 +315,13 @@ Value GroupNode::evaluate(SymbolContainer& env, const std::string& currentGroup)
  * comparisons, logical short-circuiting, and type-specific operations (like string 
  * concatenation or array merging).
  * * @param env The SymbolContainer providing access to the current variable environment.
- * @param currentGroup The string identifier for the current scope/group (defaults to "global").
+ * @param currentGroup The id of the current scope/group (defaults to global).
  * * @details 
  * ### Execution Flow:
  * 1. **Short-Circuit Logic**: For `AND` and `OR`, the right-hand side is only evaluated if 
  * the left-hand side does not determine the final result.
- * 2. **String Concatenation**: If the operator is `+` and either operand is a string, 
- * both are converted to strings and concatenated.
+ * 2. **String Concatenation**: If the operator is `+` and both operands are strings, 
+ * they are joined with Value::concat (a lazily flattened rope, see StringData).
  * 3. **Array Merging**: If both operands are arrays and the operator is `+`, a new array 
  * is returned containing elements of both.
  * 4. **Numeric Operations**: Standard arithmetic and comparison operations for doubles.
@@ -174,31 +347,75 @@ Value GroupNode::evaluate(SymbolContainer& env, const std::string& currentGroup)
  * maintain type consistency within the `Value` system.
  */
 
-Value BinOpNode::evaluate(SymbolContainer& env, const std::string& currentGroup) const {
-    Value l = left->evaluate(env, currentGroup);
+Value BinOpNode::evaluate(SymbolContainer& env, ScopeId currentGroup) const {
+    // operands are read in place where possible, see ASTNode::evaluateRef
+    Value lScratch;
+    Value rScratch;
 
     if (op == VTokenType::And) {
-        if (!l.isTruthy()) return Value(0.0);
-        return Value(right->evaluate(env, currentGroup).isTruthy() ? 1.0 : 0.0);
+        if (!left->evaluateRef(env, currentGroup, lScratch)->isTruthy()) return Value(0.0);
+        return Value(right->evaluateRef(env, currentGroup, rScratch)->isTruthy() ? 1.0 : 0.0);
     }
     
     if (op == VTokenType::Or) {
-        if (l.isTruthy()) return Value(1.0);
-        return Value(right->evaluate(env, currentGroup).isTruthy() ? 1.0 : 0.0);
+        if (left->evaluateRef(env, currentGroup, lScratch)->isTruthy()) return Value(1.0);
+        return Value(right->evaluateRef(env, currentGroup, rScratch)->isTruthy() ? 1.0 : 0.0);
+    }
+
+    if (borrowLeft) {
+        const Value* l = left->evaluateRef(env, currentGroup, lScratch);
+        return combine(*l, *right->evaluateRef(env, currentGroup, rScratch));
+    }
+
+    // the right side may run code that changes the left variable, so left is a copy
+    Value l = left->evaluate(env, currentGroup);
+    return apply(std::move(l), *right->evaluateRef(env, currentGroup, rScratch));
+}
+
+/**
+ * @brief Whether evaluating the node can't assign, call or dismiss anything.
+ * @details Literals, variables and arithmetic/indexing over those.
+ */
+
+bool BinOpNode::readsOnly(const ASTNode* node) {
+    switch (node->type()) {
+        case NodeType::NUMBER:
+        case NodeType::STRING:
+        case NodeType::BOOLEAN:
+        case NodeType::VARIABLE:
+            return true;
+        case NodeType::INDEX_ACCESS:
+            return readsOnly(static_cast<const IndexAccessNode*>(node)->getIndex());
+        case NodeType::UNARY:
+            return readsOnly(static_cast<const UnaryNode*>(node)->getRight());
+        case NodeType::BINARY_OP: {
+            auto* bin = static_cast<const BinOpNode*>(node);
+            return readsOnly(bin->left) && readsOnly(bin->right);
+        }
+        default:
+            return false;
+    }
+}
+
+Value BinOpNode::apply(Value l, const Value& r) const {
+    if (op == VTokenType::Add && l.getType() == Value::ARRAY && r.getType() == Value::ARRAY) {
+        Value result = std::move(l);
+        result.editArray().append(r.asArray());
+        return result;
     }
 
-    Value r = right->evaluate(env, currentGroup);
+    return combine(l, r);
+}
 
+Value BinOpNode::combine(const Value& l, const Value& r) const {
     if ((op == VTokenType::Add) && (l.getType() == Value::STRING && r.getType() == Value::STRING)) {
-        return Value(l.toString() + r.toString()); 
+        return Value::concat(l, r);
     }
 
     if (l.getType() == Value::ARRAY && r.getType() == Value::ARRAY) {
         if (op == VTokenType::Add) {
             Value result = l;
-            auto& resList = result.asList();
-            auto& rList = r.asList();
-            resList.insert(resList.end(), rList.begin(), rList.end());
+            result.editArray().append(r.asArray());
             return result;
         }
     }
@@ -242,12 +459,12 @@ Value BinOpNode::evaluate(SymbolContainer& env, const std::string& currentGroup)
     throw std::runtime_error("Type Error: Invalid operation " + VTokenTypeToString(op) + " between " + l.getTypeName() + " and " + r.getTypeName() + "[ " + std::to_string(lineNumber) + " ]");
 }
 
-Value PostFixNode::evaluate(SymbolContainer& env, const std::string& currentGroup) const {
+Value PostFixNode::evaluate(SymbolContainer& env, ScopeId currentGroup) const {
     if (left->type() != NodeType::VARIABLE) {
         throw std::runtime_error("Type Error: Cannot increment a non-variable [ line " + std::to_string(lineNumber) + " ]");
     }
 
-    auto* varNode = static_cast<VariableNode*>(left.get());
+    auto* varNode = static_cast<VariableNode*>(left);
 
     Value oldValue = left->evaluate(env, currentGroup);
 
@@ -257,16 +474,20 @@ Value PostFixNode::evaluate(SymbolContainer& env, const std::string& currentGrou
     switch(op){
         case VTokenType::Double_Increment : newVal = Value(rawNum + 1); break;
         case VTokenType::Double_Decrement : newVal = Value(rawNum - 1); break;
+        default: break;
     }
 
-    env[currentGroup][varNode->getNameId()] = newVal;
+    if (Value* stored = varNode->resolveLocal(env, currentGroup)) *stored = newVal;
+    else varNode->store(env, currentGroup, newVal);
 
     return newVal;
 }
 
-Value UnaryNode::evaluate(SymbolContainer& env, const std::string& currentGroup) const {
-    Value val = right->evaluate(env, currentGroup);
+Value UnaryNode::evaluate(SymbolContainer& env, ScopeId currentGroup) const {
+    return apply(right->evaluate(env, currentGroup));
+}
 
+Value UnaryNode::apply(const Value& val) const {
     switch(op){
         case VTokenType::Exclamatory : {
             return Value(!val.isTruthy());
@@ -275,30 +496,52 @@ Value UnaryNode::evaluate(SymbolContainer& env, const std::string& currentGroup)
         case VTokenType::Substract : {
             return Value(-val.asNumber());
         }
+
+        default: return Value();
     }
 }
 
-Value ArrayNode::evaluate(SymbolContainer& env, const std::string& currentGroup) const {
+Value ArrayNode::evaluate(SymbolContainer& env, ScopeId currentGroup) const {
     std::vector<Value> results;
+    results.reserve(elements.size());
     for (const auto& node : elements) results.emplace_back(node->evaluate(env, currentGroup));
-    return Value(results);
+    return Value(std::move(results));
 }
 
-Value RangeNode::evaluate(SymbolContainer& env, const std::string& currentGroup) const {
+Value MapNode::evaluate(SymbolContainer& env, ScopeId currentGroup) const {
+    auto map = std::make_shared<MapData>();
+    map->reserve(entries.size());
+
+    for (const auto& [keyNode, valueNode] : entries) {
+        Value key = keyNode->evaluate(env, currentGroup);
+        if (!key.isHashable()) {
+            throw std::runtime_error("Type Error: " + key.getTypeName() + " cannot be used as a map key [ line " + std::to_string(lineNumber) + " ]");
+        }
+        map->set(key, valueNode->evaluate(env, currentGroup));
+    }
+    return Value(map);
+}
+
+Value RangeNode::evaluate(SymbolContainer& env, ScopeId currentGroup) const {
     double start = left->evaluate(env, currentGroup).asNumber();
     double end = right->evaluate(env, currentGroup).asNumber();
     
-    std::vector<Value> rangeArray;
+    std::vector<double> rangeArray;
+    if (end >= start) rangeArray.reserve(static_cast<size_t>(end - start) + 1);
     for (double i = start; i <= end; ++i) {
-        rangeArray.emplace_back(Value(i));
+        rangeArray.emplace_back(i);
     }
-    return Value(rangeArray);
+    return Value(std::make_shared<ArrayData>(std::move(rangeArray)));
 }
 
-Value BuiltInCallNode::evaluate(SymbolContainer& env, const std::string& currentGroup) const {
+Value BuiltInCallNode::evaluate(SymbolContainer& env, ScopeId currentGroup) const {
     std::vector<Value> argValues;
     for (auto& arg : arguments) argValues.emplace_back(arg->evaluate(env, currentGroup));
 
+    return call(argValues);
+}
+
+Value BuiltInCallNode::call(std::vector<Value>& argValues) const {
     if (funcName == "out") {
         if (!argValues.empty()) { argValues[0].print(std::cout); std::cout << std::endl; }
         return Value();
@@ -328,62 +571,150 @@ Value BuiltInCallNode::evaluate(SymbolContainer& env, const std::string& current
     }
 
     if(funcName == "sequence"){
-        std::vector<Value> sequence;
-        double start = argValues[0].asNumber(), end = argValues[1].asNumber();
-
         if(argValues.size() != 2) throw std::runtime_error("Argument Error : sequence() expects 2 arguments, but got " + std::to_string(argValues.size()) + " instead [ line " + std::to_string(lineNumber) + " ]");
 
+        std::vector<double> sequence;
+        double start = argValues[0].asNumber(), end = argValues[1].asNumber();
+
+        if (end > start) sequence.reserve(static_cast<size_t>(end - start) + 1);
         for(double i = start; i < end; i++){
             sequence.emplace_back(i);
         }
 
-        return Value(sequence);
+        return Value(std::make_shared<ArrayData>(std::move(sequence)));
     } 
 
     throw std::runtime_error("Unknown built-in: " + funcName + " [ line " + std::to_string(lineNumber) + " ]");
 }
 
-Value IndexAccessNode::evaluate(SymbolContainer& env, const std::string& currentGroup) const {
-    std::string targetGroup = resolvePath(scope, currentGroup);
-    
-    if (env.count(targetGroup) && env[targetGroup].count(nameId)) {
-        Value& arrayVal = env[targetGroup][nameId];
-        Value idxVal = index->evaluate(env, currentGroup);
-        return arrayVal.asList().at(static_cast<size_t>(idxVal.asNumber()));
+Value IndexAccessNode::evaluate(SymbolContainer& env, ScopeId currentGroup) const {
+    return element(env, currentGroup, index->evaluate(env, currentGroup));
+}   
+
+Value* IndexAccessNode::localContainer(SymbolContainer& env, ScopeId currentGroup) const {
+    if (!scope.empty()) return nullptr;
+
+    if (frameSlot != FrameLayout::NO_SLOT) {
+        Local& local = env.frames().base()[frameSlot];
+        return local.bound ? &local.value : nullptr;
     }
+    return env.lookupIn(slot, currentGroup, nameId);
+}
 
-    if (targetGroup != "global" && env["global"].count(nameId)) {
-        Value& arrayVal = env["global"][nameId];
-        Value idxVal = index->evaluate(env, currentGroup);
-        return arrayVal.asList().at(static_cast<size_t>(idxVal.asNumber()));
+Value* IndexAccessNode::container(SymbolContainer& env, ScopeId currentGroup) const {
+    if (frameSlot != FrameLayout::NO_SLOT) {
+        Local& local = env.frames().base()[frameSlot];
+        if (local.bound) return &local.value;
     }
+    return env.lookup(slot, scope.empty() ? currentGroup : env.findPath(pathIds), nameId);
+}
 
-    throw std::runtime_error("Runtime Error: Array '" + originalName + "' not found [ line " + std::to_string(lineNumber) + " ]");
-}   
+const Value* IndexAccessNode::evaluateRef(SymbolContainer& env, ScopeId currentGroup, Value& scratch) const {
+    Value idxVal = index->evaluate(env, currentGroup);
+    return elementRef(env, currentGroup, idxVal, scratch);
+}
 
-Value FunctionNode::evaluate(SymbolContainer& env, const std::string& currentGroup) const {
-    Value funcValue(parameterIds, body);
+Value IndexAccessNode::element(SymbolContainer& env, ScopeId currentGroup, const Value& idxVal) const {
+    Value scratch;
+    const Value* found = elementRef(env, currentGroup, idxVal, scratch);
+    return found == &scratch ? std::move(scratch) : *found;
+}
 
-    std::string destination = targetModule.empty() ? currentGroup : "global." + targetModule;
+const Value* IndexAccessNode::elementRef(SymbolContainer& env, ScopeId currentGroup, const Value& idxVal, Value& scratch) const {
+    const Value* arrayVal = container(env, currentGroup);
+    if (!arrayVal) {
+        throw std::runtime_error("Runtime Error: Array '" + originalName + "' not found [ line " + std::to_string(lineNumber) + " ]");
+    }
+
+    if (arrayVal->getType() == Value::MAP) {
+        const Value* found = idxVal.isHashable() ? arrayVal->asMap().find(idxVal) : nullptr;
+        if (!found) throw std::runtime_error("Key Error: Key " + idxVal.toString() + " not found in map '" + originalName + "' [ line " + std::to_string(lineNumber) + " ]");
+        return found;
+    }
+
+    // packed arrays store bare doubles, those are the only elements that need a copy
+    const ArrayData& arr = arrayVal->asArray();
+    size_t idx = static_cast<size_t>(idxVal.asNumber());
+    if (arr.isPacked()) {
+        scratch = Value(arr.packedData().at(idx));
+        return &scratch;
+    }
+    return &arr.genericData().at(idx);
+}
+
+/**
+ * @brief Resolves `name[index]` to the stored element so it can be mutated in place.
+ * * @details The outer array is detached from any other owners first (copy-on-write),
+ * so the returned element is never shared with another variable.
+ * Maps are resolved the same way, by key.
+ * @return Value* The element, or nullptr if the array is packed (numbers have no methods)
+ * or the key is missing.
+ */
+
+Value* IndexAccessNode::resolveElement(SymbolContainer& env, ScopeId currentGroup, const Value& idxVal) const {
+    Value* arrayVal = container(env, currentGroup);
+    if (!arrayVal) {
+        throw std::runtime_error("Runtime Error: Array '" + originalName + "' not found [ line " + std::to_string(lineNumber) + " ]");
+    }
+    if (arrayVal->getType() == Value::MAP) {
+        return idxVal.isHashable() ? arrayVal->editMap().find(idxVal) : nullptr;
+    }
+    if (arrayVal->getType() != Value::ARRAY || arrayVal->asArray().isPacked()) return nullptr;
+
+    auto& arr = arrayVal->editArray();
+    return &arr.genericData().at(static_cast<size_t>(idxVal.asNumber()));
+}
+
+Value FunctionNode::evaluate(SymbolContainer& env, ScopeId currentGroup) const {
+    auto func = std::make_shared<FunctionData>();
+    func->params = parameterIds;
+    func->body = body;
+    func->owner = owner->shared_from_this();
+    func->frameSize = frameSize;
+    func->memo = memo;
+    func->pure = pure;
+    func->callees = callees;
+    if (memo) func->memoCache = std::make_shared<MemoCache>();
+
+    Value funcValue(std::move(func));
+
+    ScopeId destination = targetModule.empty() ? currentGroup : env.child(SymbolContainer::GLOBAL, StringPool::intern(targetModule));
 
     env[destination][funcNameId] = funcValue; 
 
     return funcValue;
 }
 
-Value FunctionCallNode::evaluate(SymbolContainer& env, const std::string& currentGroup) const {
-    auto it = env["global"].find(funcNameId);
+Value FunctionCallNode::evaluate(SymbolContainer& env, ScopeId currentGroup) const {
+    Value funcVal = callee(env);
+
+    std::vector<Value> evaluatedArgs;
+    evaluatedArgs.reserve(arguments.size());
+
+    for (const auto& arg : arguments) {
+        evaluatedArgs.emplace_back(arg->evaluate(env, currentGroup));
+    }
+
+    return invoke(env, funcVal, evaluatedArgs);
+}
+
+Value FunctionCallNode::callee(SymbolContainer& env) const {
+    const Value* func = env.lookup(slot, SymbolContainer::GLOBAL, funcNameId);
     
-    if (it == env["global"].end()) {
+    if (!func) {
         throw std::runtime_error("Runtime Error: " + originalName + " is not defined in global scope [ line " + std::to_string(lineNumber) + " ]");
     }
 
-    Value funcVal = it->second;
-
-    if (funcVal.getType() != Value::FUNCTION) {
+    if (func->getType() != Value::FUNCTION) {
         throw std::runtime_error("Type Error: " + originalName + " is not a function [ line " + std::to_string(lineNumber) + " ]");
     }
 
+    return *func;
+}
+
+void FunctionCallNode::prepareTail(SymbolContainer& env, ScopeId currentGroup) const {
+    Value funcVal = callee(env);
+
     std::vector<Value> evaluatedArgs;
     evaluatedArgs.reserve(arguments.size());
 
@@ -391,39 +722,148 @@ Value FunctionCallNode::evaluate(SymbolContainer& env, const std::string& curren
         evaluatedArgs.emplace_back(arg->evaluate(env, currentGroup));
     }
 
-    std::string localScope = "call_" + originalName + "_" + std::to_string(rand());
+    TailCall& tail = env.tailCall();
+    tail.call = this;
+    tail.callee = std::move(funcVal);
+    tail.args = std::move(evaluatedArgs);
+}
+
+/**
+ * @brief Calls a user function, then keeps running the tail calls it returns with.
+ * * @details A body that ends in `return g(...)` leaves g parked in
+ * env.tailCall(). Its frame is gone by then, g runs in the next iteration
+ * here, so a chain of tail calls takes one C++ frame and one call frame.
+ */
+
+Value FunctionCallNode::invoke(SymbolContainer& env, const Value& funcVal, std::vector<Value>& evaluatedArgs, const FlatProgram* flat) const {
+    if (funcVal.asFunction()->memo) return invokeMemo(env, funcVal, evaluatedArgs, flat);
+
+    Value result = enter(env, funcVal, evaluatedArgs, flat);
+
+    TailCall& tail = env.tailCall();
+    while (tail.call) {
+        const FunctionCallNode* next = tail.call;
+        Value nextFunc = std::move(tail.callee);
+        std::vector<Value> nextArgs = std::move(tail.args);
+        tail.call = nullptr;
+
+        // a memo sub has to see its own result to store it, it doesn't take part in the loop
+        if (nextFunc.asFunction()->memo) return next->invokeMemo(env, nextFunc, nextArgs, flat);
+        result = next->enter(env, nextFunc, nextArgs, flat);
+    }
+
+    return result;
+}
+
+Value FunctionCallNode::invokeMemo(SymbolContainer& env, const Value& funcVal, std::vector<Value>& evaluatedArgs, const FlatProgram* flat) const {
+    FunctionData& func = *funcVal.asFunction();
+
+    // the threads of a parallel loop share the cache, the loop already checked the sub
+    const bool shared = SymbolContainer::onWorker();
+    if (!shared) MemoCache::verify(env, func, funcNameId, lineNumber);
+
+    if (!MemoCache::cacheable(evaluatedArgs)) {
+        Value result = enter(env, funcVal, evaluatedArgs, flat);
+        return finishTail(env, std::move(result), flat);
+    }
 
+    if (shared) {
+        Value hit;
+        if (func.memoCache->findShared(evaluatedArgs, hit)) return hit;
+    } else if (const Value* hit = func.memoCache->find(evaluatedArgs)) {
+        return *hit;
+    }
+
+    std::vector<Value> key = evaluatedArgs;
+    Value result = finishTail(env, enter(env, funcVal, evaluatedArgs, flat), flat);
+
+    if (shared) func.memoCache->storeShared(std::move(key), result);
+    else func.memoCache->store(std::move(key), result);
+    return result;
+}
+
+Value FunctionCallNode::finishTail(SymbolContainer& env, Value result, const FlatProgram* flat) {
+    TailCall& tail = env.tailCall();
+    if (!tail.call) return result;
+
+    const FunctionCallNode* next = tail.call;
+    Value nextFunc = std::move(tail.callee);
+    std::vector<Value> nextArgs = std::move(tail.args);
+    tail.call = nullptr;
+    return next->invoke(env, nextFunc, nextArgs, flat);
+}
+
+Value FunctionCallNode::enter(SymbolContainer& env, const Value& funcVal, std::vector<Value>& evaluatedArgs, const FlatProgram* flat) const {
     auto& params = funcVal.asFunction()->params;
 
     if (params.size() != evaluatedArgs.size()) {
         throw std::runtime_error("Argument Error: Argument count mismatch on function call " + originalName + " [ line " + std::to_string(lineNumber) + " ]");
     }
-    
-    for (size_t i = 0; i < params.size(); ++i) {
-        env[localScope][params[i]] = std::move(evaluatedArgs[i]);
+
+    const auto& func = *funcVal.asFunction();
+    const FlatProgram::Span* flatBody = flat ? flat->bodyOf(func) : nullptr;
+
+    // locals live in a frame slot when the body has a layout, in a call scope otherwise
+    const bool framed = func.frameSize != FrameLayout::NO_FRAME;
+    ScopeId localScope = SymbolContainer::GLOBAL;
+
+    if (framed) {
+        Local* frame = env.frames().push(func.frameSize);
+        for (size_t i = 0; i < params.size(); ++i) {
+            frame[i].value = std::move(evaluatedArgs[i]);
+            frame[i].bound = true;
+        }
+    } else {
+        localScope = env.open(SymbolContainer::GLOBAL, funcNameId);
+        for (size_t i = 0; i < params.size(); ++i) {
+            env[localScope][params[i]] = std::move(evaluatedArgs[i]);
+        }
     }
 
+    auto leave = [&]() {
+        if (framed) env.frames().pop();
+        else env.close(localScope);
+    };
+
     Value result;
     try {
-        for (const auto& bodyNode : funcVal.asFunction()->body) {
-            result = bodyNode->evaluate(env, localScope);
+        if (flatBody) {
+            result = flat->runBody(*flatBody, env, localScope);
+        } else {
+            for (const auto& bodyNode : func.body) {
+                result = bodyNode->evaluate(env, localScope);
+            }
         }
     } catch (const ReturnException& e) {
         result = e.value; 
+    } catch (...) {
+        leave();
+        throw;
     }
 
-    if (env.find(localScope) != env.end()) {
-        env[localScope].clear();
-        env.erase(localScope);
-    }
-
+    leave();
     return result;
 }
 
-Value ReturnNode::evaluate(SymbolContainer& env, const std::string& currentGroup) const {
+Value ReturnNode::evaluate(SymbolContainer& env, ScopeId currentGroup) const {
+    if (tailCall) {
+        static_cast<const FunctionCallNode*>(expression)->prepareTail(env, currentGroup);
+        throw ReturnException{Value()};
+    }
     throw ReturnException{expression->evaluate(env, currentGroup)};
 }
 
+void ReturnNode::markTailCalls() {
+    tailCall = expression && expression->type() == NodeType::FUNCTION_CALL;
+}
+
+bool MethodCallNode::ownsReceiver(SymbolContainer& env, ScopeId currentGroup) const {
+    if (receiver->type() == NodeType::VARIABLE) {
+        return static_cast<const VariableNode*>(receiver)->resolveLocal(env, currentGroup) != nullptr;
+    }
+    return static_cast<const IndexAccessNode*>(receiver)->localContainer(env, currentGroup) != nullptr;
+}
+
 /**
  * @brief Dispatches and executes method calls on a receiver object.
  * * @details This method serves as the central hub for "Dot Notation" syntax. 
@@ -437,7 +877,11 @@ Value ReturnNode::evaluate(SymbolContainer& env, const std::string& currentGroup
  * - `pop()`: Removes the last element.
  * - `delete(val)`: Erases a specific value.
  * - `sort()`, `reverse()`, `clear()`, `place_all(val, count)`.
- * * @note Array methods require the receiver to be a named variable (L-Value) 
+ * * 3. **Built-in Map Methods:** When the receiver is a MAP:
+ * - `size()`, `keys()`, `has(key)`.
+ * - `get(key)` / `get(key, fallback)`: Looks a key up, fallback is returned when missing.
+ * - `set(key, val)`, `remove(key)`: Insert/overwrite and erase entries.
+ * * @note Mutating methods require the receiver to be a named variable (L-Value) 
  * to allow for in-place modification.
  * * @param env The current SymbolContainer holding global and scoped variables.
  * @param currentGroup The active namespace/group context of the caller.
@@ -446,35 +890,100 @@ Value ReturnNode::evaluate(SymbolContainer& env, const std::string& currentGroup
  * * @return Value The result of the function execution or the modified receiver object.
  */
 
-Value MethodCallNode::evaluate(SymbolContainer& env, const std::string& currentGroup) const {
-    Value receiverVal = receiver->evaluate(env, currentGroup);
-    uint32_t methodId = StringPool::instance().intern(methodName);
+Value MethodCallNode::evaluate(SymbolContainer& env, ScopeId currentGroup) const {
+    // Named receivers are read in place: holding a copy of an array while
+    // mutating it would make the copy-on-write storage look shared.
+    Value receiverVal;
+    Value indexVal;
+    const Value* recv = &receiverVal;
+
+    if (receiver->type() == NodeType::INDEX_ACCESS) {
+        auto* idx = static_cast<const IndexAccessNode*>(receiver);
+        indexVal = idx->evaluateIndex(env, currentGroup);
+        recv = idx->elementRef(env, currentGroup, indexVal, receiverVal);
+    } else {
+        recv = receiver->evaluateRef(env, currentGroup, receiverVal);
+    }
 
-    if (receiverVal.getType() == Value::MODULE) {
-        std::string modName = receiverVal.asModule();
-        std::string modPath = "global." + modName; 
+    if (recv->getType() == Value::MODULE) {
+        std::string modName = recv->asModule();
+        if (SymbolContainer::onWorker() && modName != "vmath") {
+            throw std::runtime_error("Runtime Error: Cannot call " + modName + "." + methodName + "() inside a parallel loop, only vmath is safe there [ line " + std::to_string(lineNumber) + " ]");
+        }
+        ScopeId modPath = env.findChild(SymbolContainer::GLOBAL, std::get<ModuleData>(recv->data).moduleId);
 
-        if (env.count(modPath) && env[modPath].count(methodId)) {
-            Value& funcVal = env[modPath][methodId];
+        Value* member = nullptr;
+        if (modPath != SymbolContainer::NONE) {
+            auto found = env[modPath].find(methodId);
+            if (found != env[modPath].end()) member = &found->second;
+        }
 
-            if (funcVal.getType() == Value::FUNCTION) {
-                auto func = funcVal.asFunction();
+        if (member) {
+            if (member->getType() == Value::FUNCTION) {
+                auto func = member->asFunction();
+
+                if (func->isNative) {
+                    // arguments live on the stack, only unusually long calls spill to the heap
+                    constexpr size_t INLINE_ARGS = 8;
+                    std::array<Value, INLINE_ARGS> inlineArgs;
+                    std::vector<Value> spilled;
+
+                    const size_t argc = arguments.size();
+                    Value* args = inlineArgs.data();
+                    if (argc > INLINE_ARGS) {
+                        spilled.resize(argc);
+                        args = spilled.data();
+                    }
+
+                    size_t next = 0;
+                    for (auto& arg : arguments) {
+                        args[next++] = arg->evaluate(env, currentGroup);
+                    }
+
+                    if (func->arity >= 0 && argc != static_cast<size_t>(func->arity)) {
+                        throw std::runtime_error("Argument Error: " + modName + "." + methodName + "() expects "
+                            + std::to_string(func->arity) + (func->arity == 1 ? " argument" : " arguments")
+                            + ", but got " + std::to_string(argc) + " instead [ line " + std::to_string(lineNumber) + " ]");
+                    }
+
+                    NativeContext ctx{env, *func, lineNumber, modName, methodName};
+                    return func->nativeFn(args, argc, ctx);
+                }
 
                 std::vector<Value> argValues;
                 for (auto& arg : arguments) {
                     argValues.emplace_back(arg->evaluate(env, currentGroup));
                 }
 
-                if (func->isNative) {
-                    return func->nativeFn(argValues); 
-                } 
+                std::vector<Value> memoKey;
+                bool memoize = func->memo && MemoCache::cacheable(argValues);
+                if (func->memo) MemoCache::verify(env, *func, methodId, lineNumber);
+                if (memoize) {
+                    if (const Value* hit = func->memoCache->find(argValues)) return *hit;
+                    memoKey = argValues;
+                }
 
-                const std::string& localCallScope = modPath + ".call_" + std::to_string(rand());
+                const bool framed = func->frameSize != FrameLayout::NO_FRAME;
+                ScopeId localCallScope = modPath;
 
-                for (size_t i = 0; i < func->params.size() && i < argValues.size(); ++i) {
-                    env[localCallScope][func->params[i]] = std::move(argValues[i]);
+                if (framed) {
+                    Local* frame = env.frames().push(func->frameSize);
+                    for (size_t i = 0; i < func->params.size() && i < argValues.size(); ++i) {
+                        frame[i].value = std::move(argValues[i]);
+                        frame[i].bound = true;
+                    }
+                } else {
+                    localCallScope = env.open(modPath, methodId);
+                    for (size_t i = 0; i < func->params.size() && i < argValues.size(); ++i) {
+                        env[localCallScope][func->params[i]] = std::move(argValues[i]);
+                    }
                 }
 
+                auto leave = [&]() {
+                    if (framed) env.frames().pop();
+                    else env.close(localCallScope);
+                };
+
                 Value result(0.0); 
                 try {
                     for (auto& stmt : func->body) {
@@ -482,9 +991,16 @@ Value MethodCallNode::evaluate(SymbolContainer& env, const std::string& currentG
                     }
                 } catch (const ReturnException& e) {
                     result = e.value;
+                } catch (...) {
+                    leave();
+                    throw;
                 }
 
-                env.erase(localCallScope);
+                leave();
+
+                // a tail call the method returned with runs from here on
+                result = FunctionCallNode::finishTail(env, std::move(result));
+                if (memoize) func->memoCache->store(std::move(memoKey), result);
 
                 return result;
             }
@@ -492,107 +1008,185 @@ Value MethodCallNode::evaluate(SymbolContainer& env, const std::string& currentG
         throw std::runtime_error("Module Error: Method '" + methodName + "' not found in module " + modName + " [ line " + std::to_string(lineNumber) + " ]");
     }
 
-    // --- ARRAY METHODS ---
-    if (receiverVal.getType() == Value::ARRAY) {
-        if (methodName == "size") {
-            return Value(static_cast<double>(receiverVal.asList().size()));
+    bool isNamed = receiver->type() == NodeType::VARIABLE || receiver->type() == NodeType::INDEX_ACCESS;
+
+    // Arguments are evaluated before this is called, they may reassign the receiver.
+    // Anonymous receivers are changed as a temporary, named ones in place.
+    auto resolveTarget = [&]() -> Value* {
+        if (!isNamed) return &receiverVal;
+
+        receiverVal = Value();
+        // the threads of a parallel loop may only change what is in their own scope
+        if (SymbolContainer::onWorker() && !ownsReceiver(env, currentGroup)) {
+            throw std::runtime_error("Runtime Error: Cannot call '" + methodName + "' on a variable of the enclosing scope inside a parallel loop [ line " + std::to_string(lineNumber) + " ]");
         }
 
-        Value* target = nullptr;
+        if (receiver->type() == NodeType::VARIABLE) {
+            auto* var = static_cast<const VariableNode*>(receiver);
+            return var->resolve(env, currentGroup);
+        }
+        return static_cast<const IndexAccessNode*>(receiver)->resolveElement(env, currentGroup, indexVal);
+    };
 
+    // Same for methods that only read, without detaching shared storage.
+    auto borrowReceiver = [&]() -> const Value* {
         if (receiver->type() == NodeType::VARIABLE) {
-            auto* var = static_cast<VariableNode*>(receiver.get());
-            std::string targetGroup = resolvePath(var->getScope(), currentGroup);
-            if (env.count(targetGroup) && env[targetGroup].count(var->getNameId())) {
-                target = &env[targetGroup][var->getNameId()];
-            } else if (targetGroup != "global" && env["global"].count(var->getNameId())) {
-                target = &env["global"][var->getNameId()];
-            }
-        } 
-        else if (receiver->type() == NodeType::INDEX_ACCESS) {
-            target = &receiverVal;
+            receiverVal = Value();
+            return static_cast<const VariableNode*>(receiver)->resolve(env, currentGroup);
         }
+        if (receiver->type() == NodeType::INDEX_ACCESS) {
+            return static_cast<const IndexAccessNode*>(receiver)->elementRef(env, currentGroup, indexVal, receiverVal);
+        }
+        return &receiverVal;
+    };
 
-        if (!target && (methodName == "push" || methodName == "pop" || methodName == "clear")) {
+    // --- ARRAY METHODS ---
+    if (recv->getType() == Value::ARRAY) {
+        if (methodName == "size") {
+            return Value(static_cast<double>(recv->asArray().size()));
+        }
+
+        if (!isNamed && (methodName == "push" || methodName == "pop" || methodName == "clear")) {
             throw std::runtime_error("Runtime Error: Cannot call mutating method '" + methodName + "' on anonymous array [ line " + std::to_string(lineNumber) + " ]");
         }
 
-        auto& vec = target ? target->asList() : receiverVal.asList();
+        std::vector<Value> argValues;
+        argValues.reserve(arguments.size());
+        for (auto& arg : arguments) argValues.emplace_back(arg->evaluate(env, currentGroup));
 
-        if (methodName == "push") {
-            if (target->getType() != Value::ARRAY) throw std::runtime_error("Type Error : Called method push() on non-array [ line " + std::to_string(lineNumber) + " ]");
+        Value* target = resolveTarget();
 
-            for(auto& arg : arguments){
-                Value val = arg->evaluate(env, currentGroup);
-                target->asList().emplace_back(val);
-            }
+        if (!target || target->getType() != Value::ARRAY) {
+            throw std::runtime_error("Type Error : Called method " + methodName + "() on non-array [ line " + std::to_string(lineNumber) + " ]");
+        }
 
-            return receiverVal;
+        if (methodName == "push") {
+            auto& arr = target->editArray();
+            for (const auto& val : argValues) arr.push(val);
+
+            return *target;
         }
 
         if (methodName == "pop") {
-            if (target->getType() != Value::ARRAY) throw std::runtime_error("Type Error : Called method pop() on non-array [ line " + std::to_string(lineNumber) + " ]");
-            if (target->asList().empty()) throw std::runtime_error("Index Error: pop() from empty array [ line " + std::to_string(lineNumber) + " ]");
+            if (target->asArray().empty()) throw std::runtime_error("Index Error: pop() from empty array [ line " + std::to_string(lineNumber) + " ]");
             if (!arguments.empty()) throw std::runtime_error("Argument Error: pop() expects 0 arguments, but got " + std::to_string(arguments.size()) + " [ line " + std::to_string(lineNumber) + " ]");
 
-            target->asList().pop_back();
+            target->editArray().pop();
             return Value(true);
         }
 
         if (methodName == "delete") {
-            if (target->getType() != Value::ARRAY) throw std::runtime_error("Type Error : Called method delete() on non-array [ line " + std::to_string(lineNumber) + " ]");
             if (arguments.size() != 1) throw std::runtime_error("Argument Error: delete() expects exactly 1 argument, but got " + std::to_string(arguments.size()) + " instead [ line " + std::to_string(lineNumber) + " ]");
 
-            Value val = arguments[0]->evaluate(env, currentGroup);
-            auto it = std::find(target->asList().begin(), target->asList().end(), val);
-            if (it == std::end(target->asList())) throw std::runtime_error("Value error : Could not find given value in array! [ line " + std::to_string(lineNumber) + " ]");
-            target->asList().erase(it);
+            if (!target->editArray().erase(argValues[0])) throw std::runtime_error("Value error : Could not find given value in array! [ line " + std::to_string(lineNumber) + " ]");
             return Value(true);
         }
 
         if (methodName == "sort") {
-            if (target->getType() != Value::ARRAY) throw std::runtime_error("Type Error: sort() called on non-array [ line " + std::to_string(lineNumber) + " ]");
             if (!arguments.empty()) throw std::runtime_error("Argument Error: sort() expects 0 arguments [ line " + std::to_string(lineNumber) + " ]");
-            for (auto& el : target->asList()) {
-                if (el.getType() != Value::NUMBER) throw std::runtime_error("Value Error: Cannot sort string values [ line " + std::to_string(lineNumber) + " ]");
-            }
-            std::sort(target->asList().begin(), target->asList().end());
+
+            auto& arr = target->editArray();
+            if (!arr.tryPack()) throw std::runtime_error("Value Error: Cannot sort string values [ line " + std::to_string(lineNumber) + " ]");
+            std::sort(arr.packedData().begin(), arr.packedData().end());
             return Value(*target); 
         }
 
         if (methodName == "place_all") {
-            if (target->getType() != Value::ARRAY) 
-                throw std::runtime_error("Type Error: place_all() called on non-array [ line " + std::to_string(lineNumber) + " ]");
-
-            Value element = arguments[0]->evaluate(env, currentGroup);
-            Value countVal = arguments[1]->evaluate(env, currentGroup);
-            int count = static_cast<int>(countVal.asNumber());
-
-            auto& targetVec = target->asList();
-            
-            targetVec.clear(); 
-            targetVec.reserve(count);
-            
-            for (int i = 0; i < count; i++) {
-                targetVec.emplace_back(element);
+            if (arguments.size() != 2) throw std::runtime_error("Argument Error: place_all() expects 2 arguments, but got " + std::to_string(arguments.size()) + " instead [ line " + std::to_string(lineNumber) + " ]");
+
+            const Value& element = argValues[0];
+            int count = static_cast<int>(argValues[1].asNumber());
+
+            auto& arr = target->editArray();
+            arr.clear();
+
+            if (element.getType() == Value::NUMBER) {
+                arr.packedData().assign(static_cast<size_t>(std::max(count, 0)), element.asNumber());
+                return *target;
             }
 
+            arr.spill();
+            arr.genericData().assign(static_cast<size_t>(std::max(count, 0)), element);
             return *target; 
         }
 
         if (methodName == "reverse") {
-            if (target->getType() != Value::ARRAY) throw std::runtime_error("Type Error: reverse() called on non-array [ line " + std::to_string(lineNumber) + " ]");
             if (arguments.size() > 0) throw std::runtime_error("Argument Error: reverse() expects 0 arguments, but got " + std::to_string(arguments.size()) + " instead [ line " + std::to_string(lineNumber) + " ]");
-            std::reverse(target->asList().begin(), target->asList().end());
+
+            auto& arr = target->editArray();
+            if (arr.isPacked()) std::reverse(arr.packedData().begin(), arr.packedData().end());
+            else std::reverse(arr.genericData().begin(), arr.genericData().end());
             return Value(*target);
         }
 
         if (methodName == "clear") {
-            if (target->getType() != Value::ARRAY) throw std::runtime_error("Type Error: clear() called on non-array [ line " + std::to_string(lineNumber) + " ]");
             if (arguments.size() > 0) throw std::runtime_error("Argument Error: clear() expects 0 arguments, but got " + std::to_string(arguments.size()) + " instead [ line " + std::to_string(lineNumber) + " ]");
-            target->asList().clear();
+            target->editArray().clear();
             return Value(*target);
         }
+
+        // the arguments may have reassigned the receiver, recv can't be read again
+        throw std::runtime_error("Unknown method: " + methodName + " [ line " + std::to_string(lineNumber) + " ]");
+    }
+
+    // --- MAP METHODS ---
+    if (recv->getType() == Value::MAP) {
+        if (methodName == "size") {
+            return Value(static_cast<double>(recv->asMap().size()));
+        }
+
+        if (methodName == "keys") {
+            if (!arguments.empty()) throw std::runtime_error("Argument Error: keys() expects 0 arguments, but got " + std::to_string(arguments.size()) + " instead [ line " + std::to_string(lineNumber) + " ]");
+            return Value(recv->asMap().keys());
+        }
+
+        std::vector<Value> argValues;
+        argValues.reserve(arguments.size());
+        for (auto& arg : arguments) argValues.emplace_back(arg->evaluate(env, currentGroup));
+
+        if (!argValues.empty() && !argValues[0].isHashable()) {
+            throw std::runtime_error("Type Error: " + argValues[0].getTypeName() + " cannot be used as a map key [ line " + std::to_string(lineNumber) + " ]");
+        }
+
+        if (methodName == "get") {
+            if (argValues.empty() || argValues.size() > 2) throw std::runtime_error("Argument Error: get() expects 1 or 2 arguments, but got " + std::to_string(argValues.size()) + " instead [ line " + std::to_string(lineNumber) + " ]");
+
+            const Value* map = borrowReceiver();
+            const Value* found = map && map->getType() == Value::MAP ? map->asMap().find(argValues[0]) : nullptr;
+
+            if (found) return *found;
+            if (argValues.size() == 2) return argValues[1];
+            throw std::runtime_error("Key Error: Key " + argValues[0].toString() + " not found in map [ line " + std::to_string(lineNumber) + " ]");
+        }
+
+        if (methodName == "has") {
+            if (argValues.size() != 1) throw std::runtime_error("Argument Error: has() expects exactly 1 argument, but got " + std::to_string(argValues.size()) + " instead [ line " + std::to_string(lineNumber) + " ]");
+
+            const Value* map = borrowReceiver();
+            return Value(map && map->getType() == Value::MAP && map->asMap().has(argValues[0]));
+        }
+
+        if (methodName == "set" || methodName == "remove") {
+            if (!isNamed) throw std::runtime_error("Runtime Error: Cannot call mutating method '" + methodName + "' on anonymous map [ line " + std::to_string(lineNumber) + " ]");
+
+            Value* target = resolveTarget();
+            if (!target || target->getType() != Value::MAP) {
+                throw std::runtime_error("Type Error : Called method " + methodName + "() on non-map [ line " + std::to_string(lineNumber) + " ]");
+            }
+            if (target->isReadOnly) {
+                throw std::runtime_error("Runtime Error: Cannot modify read-only map [ line " + std::to_string(lineNumber) + " ]");
+            }
+
+            if (methodName == "set") {
+                if (argValues.size() != 2) throw std::runtime_error("Argument Error: set() expects 2 arguments, but got " + std::to_string(argValues.size()) + " instead [ line " + std::to_string(lineNumber) + " ]");
+
+                target->editMap().set(argValues[0], argValues[1]);
+                return argValues[1];
+            }
+
+            if (argValues.size() != 1) throw std::runtime_error("Argument Error: remove() expects exactly 1 argument, but got " + std::to_string(argValues.size()) + " instead [ line " + std::to_string(lineNumber) + " ]");
+            return Value(target->editMap().remove(argValues[0]));
+        }
     }
     
     throw std::runtime_error("Unknown method: " + methodName + " [ line " + std::to_string(lineNumber) + " ]");
@@ -605,10 +1199,11 @@ Value MethodCallNode::evaluate(SymbolContainer& env, const std::string& currentG
  * - @b Continue: Caught via ContinueException to skip to the next iteration.
  * * */
 
-Value WhileNode::evaluate(SymbolContainer& env, const std::string& currentGroup) const {
+Value WhileNode::evaluate(SymbolContainer& env, ScopeId currentGroup) const {
     Value lastResult;
     while (condition->evaluate(env, currentGroup).isTruthy()) {
         try {
+            lastResult = Value();
             lastResult = body->evaluate(env, currentGroup);
         } catch (const BreakException&) { break; }
         catch (const ContinueException&) { continue; }
@@ -616,13 +1211,16 @@ Value WhileNode::evaluate(SymbolContainer& env, const std::string& currentGroup)
     return lastResult;
 }
 
-Value ForNode::evaluate(SymbolContainer& env, const std::string& currentGroup) const {
+Value ForNode::evaluate(SymbolContainer& env, ScopeId currentGroup) const {
     Value collection = iterable->evaluate(env, currentGroup);
     if (collection.getType() != Value::ARRAY) {
         throw std::runtime_error("Runtime Error: 'through' requires a sequence or range [ line " + std::to_string(lineNumber) + " ]");
     }
 
-    const auto& elements = collection.asList();
+    const auto& elements = collection.asArray();
+    // a parallel loop inside another one runs on that loop's thread
+    if (parallel && !SymbolContainer::onWorker()) return evaluateParallel(env, currentGroup, elements);
+
     auto& scope = env[currentGroup];
     uint32_t itId = StringPool::instance().intern(iteratorName);
 
@@ -630,30 +1228,39 @@ Value ForNode::evaluate(SymbolContainer& env, const std::string& currentGroup) c
     bool hadIt = (scope.find(itId) != scope.end());
     if (hadIt) savedIt = scope[itId];
 
-    std::vector<Value> resultList;
+    auto resultList = std::make_shared<ArrayData>();
     std::set<Value> seen;
     Value lastVal;
 
-    for (const auto& element : elements) {
-        scope[itId] = element;
+    // packed arrays hand out their doubles directly, generic ones by reference
+    const size_t count = elements.size();
+    Value packedElement;
+
+    for (size_t i = 0; i < count && i < elements.size(); ++i) {
+        const Value* element = &packedElement;
+        if (elements.isPacked()) packedElement = Value(elements.packedData()[i]);
+        else element = &elements.genericData()[i];
+
+        scope[itId] = *element;
+        lastVal = Value();
         
         try {
             Value currentResult = body->evaluate(env, currentGroup);
 
             switch(mode) {
                 case ForMode::COLLECT:          
-                    resultList.emplace_back(currentResult);
+                    resultList->push(currentResult);
                     break;
                 case ForMode::FILTER:
-                    if (currentResult.asNumber() != 0) resultList.emplace_back(element);
+                    if (currentResult.asNumber() != 0) resultList->push(*element);
                     break;
                 case ForMode::LOOP: 
                     lastVal = currentResult;
                     break;
                 case ForMode::UNIQUE : {
-                    if(seen.find(element) == seen.end()){
-                        seen.insert(element);
-                        resultList.emplace_back(element);
+                    if(seen.find(*element) == seen.end()){
+                        seen.insert(*element);
+                        resultList->push(*element);
                     }
                     break;
                 }
@@ -676,7 +1283,142 @@ Value ForNode::evaluate(SymbolContainer& env, const std::string& currentGroup) c
     return lastVal;
 }
 
-Value IfNode::evaluate(SymbolContainer& env, const std::string& currentGroup) const {
+/**
+ * @brief `through xs -> parallel collect|filter|every`: the body runs for
+ * several elements at once, on the threads of the WorkerPool.
+ * @details Checked before anything runs: the body changes nothing but its
+ * own locals (FrameLayout::isIsolated), none of those exists in the enclosing
+ * scope yet (the sequential loop would write it there), and every sub it
+ * calls is pure and runs in a frame (MemoCache::findImpure). What the threads
+ * share is then only read.
+ * * Each thread gets a scope of its own below currentGroup, emptied for every
+ * element, holding the iterator and whatever the body assigns. Results are
+ * stored by element index and merged in order. `break`, `continue` and
+ * errors act as in the sequential loop: the lowest index that stops wins,
+ * whatever came after it is dropped.
+ */
+Value ForNode::evaluateParallel(SymbolContainer& env, ScopeId currentGroup, const ArrayData& elements) const {
+    const std::string where = " [ line " + std::to_string(lineNumber) + " ]";
+    if (!isolated) {
+        throw std::runtime_error("Runtime Error: Cannot run 'through' in parallel, its body changes state outside its own scope" + where);
+    }
+
+    // an assignment updates the name wherever the scope chain holds it, not only here
+    for (uint32_t id : assigned) {
+        if (env.lookup(currentGroup, id)) {
+            throw std::runtime_error("Runtime Error: Cannot run 'through' in parallel, its body assigns '" + StringPool::instance().get(id) +
+                                     "', a variable of the enclosing scope" + where);
+        }
+    }
+
+    std::vector<std::pair<const FunctionData*, uint32_t>> subs;
+    CalleeBindings reached;
+    auto& global = env[SymbolContainer::GLOBAL];
+    for (uint32_t id : callees) {
+        auto it = global.find(id);
+        if (it == global.end() || it->second.getType() != Value::FUNCTION) continue;
+        subs.emplace_back(it->second.asFunction().get(), id);
+        reached.emplace_back(id, it->second.asFunction());
+    }
+    uint32_t unsafe = MemoCache::findImpure(env, std::move(subs), true, &reached);
+    if (unsafe != MemoCache::ALL_PURE) {
+        throw std::runtime_error("Runtime Error: Cannot run 'through' in parallel, it calls '" + StringPool::instance().get(unsafe) +
+                                 "' which is not a pure sub" + where);
+    }
+
+    // the threads skip MemoCache::verify, drop results of redefined callees here
+    for (const auto& [id, bound] : reached) {
+        if (auto sub = bound.lock(); sub && sub->memo) MemoCache::verify(env, *sub, id, lineNumber);
+    }
+
+    const size_t count = elements.size();
+    WorkerPool& pool = WorkerPool::instance();
+    const size_t workers = std::max<size_t>(1, std::min(pool.size(), count));
+    // small enough to even out uneven bodies, large enough to keep the counter cold
+    const size_t chunk = std::max<size_t>(1, count / (workers * 8));
+    const uint32_t itId = StringPool::instance().intern(iteratorName);
+
+    std::vector<Value> results(mode == ForMode::COLLECT ? count : 0);
+    std::vector<uint8_t> kept(count, 0);   // collect: the body ran to the end, filter: it was truthy
+    Value last;                           // every: result for the last element
+
+    struct Stop {
+        size_t index = SIZE_MAX;          // first element that ended the loop
+        std::exception_ptr error;         // nullptr for `break`
+    };
+    std::vector<Stop> stops(workers);
+    std::atomic<size_t> stopAt{count};
+    std::atomic<size_t> next{0};
+
+    std::vector<ScopeId> scopes;
+    for (size_t i = 0; i < workers; ++i) scopes.push_back(env.open(currentGroup, itId));
+
+    auto work = [&](size_t worker) {
+        thread_local SymbolContainer::WorkerState state;
+        SymbolContainer::WorkerThread running(state);
+        SymbolTable& vars = env[scopes[worker]];
+        Stop& stop = stops[worker];
+
+        for (size_t begin; (begin = next.fetch_add(chunk)) < count;) {
+            const size_t end = std::min(count, begin + chunk);
+
+            for (size_t i = begin; i < end; ++i) {
+                if (i > stopAt.load(std::memory_order_relaxed)) return;
+
+                vars.clear();
+                vars[itId] = elements.isPacked() ? Value(elements.packedData()[i]) : elements.genericData()[i];
+
+                try {
+                    Value result = body->evaluate(env, scopes[worker]);
+                    if (mode == ForMode::COLLECT) {
+                        results[i] = std::move(result);
+                        kept[i] = 1;
+                    } else if (mode == ForMode::FILTER) {
+                        kept[i] = result.asNumber() != 0;
+                    } else if (i == count - 1) {
+                        last = std::move(result);
+                    }
+                    continue;
+                } catch (const BreakException&) {
+                    stop.index = i;
+                } catch (const ContinueException&) {
+                    continue;
+                } catch (...) {
+                    stop.index = i;
+                    stop.error = std::current_exception();
+                }
+
+                // later elements are dropped anyway, let the others skip them
+                size_t seen = stopAt.load();
+                while (i < seen && !stopAt.compare_exchange_weak(seen, i)) {}
+                return;
+            }
+        }
+    };
+
+    pool.run(workers, work);
+
+    for (ScopeId scope : scopes) env.close(scope);
+
+    Stop first;
+    for (Stop& stop : stops) {
+        if (stop.index < first.index) first = std::move(stop);
+    }
+    if (first.error) std::rethrow_exception(first.error);
+
+    const size_t merged = std::min(first.index, count);
+    if (mode == ForMode::EVERY) return merged == count ? last : Value();
+
+    std::vector<Value> items;
+    for (size_t i = 0; i < merged; ++i) {
+        if (!kept[i]) continue;
+        if (mode == ForMode::COLLECT) items.push_back(std::move(results[i]));
+        else items.push_back(elements.isPacked() ? Value(elements.packedData()[i]) : elements.genericData()[i]);
+    }
+    return Value(std::make_shared<ArrayData>(std::move(items)));
+}
+
+Value IfNode::evaluate(SymbolContainer& env, ScopeId currentGroup) const {
     try{
         if(condition->evaluate(env, currentGroup).isTruthy()){
             return body->evaluate(env, currentGroup);
@@ -689,9 +1431,12 @@ Value IfNode::evaluate(SymbolContainer& env, const std::string& currentGroup) co
     return Value();
 }
 
-Value BlockNode::evaluate(SymbolContainer& env, const std::string& currentGroup) const {
+Value BlockNode::evaluate(SymbolContainer& env, ScopeId currentGroup) const {
     Value lastValue;
-    for (const auto& statement : statements) lastValue = statement->evaluate(env, currentGroup);
+    for (const auto& statement : statements) {
+        lastValue = Value();
+        lastValue = statement->evaluate(env, currentGroup);
+    }
     return lastValue; 
 }
 
@@ -699,76 +1444,43 @@ Value BlockNode::evaluate(SymbolContainer& env, const std::string& currentGroup)
  * @brief Registers and initializes external modules within the current scope.
  * * When a `module` keyword is encountered, this node triggers the setup functions 
  * for native libraries (like vcore or vglib).
- * * @param env The global symbol container mapping scope paths to symbol tables.
- * @param currentGroup The current hierarchical scope path (e.g., "global.main").
+ * * @param env The global symbol container holding the scope tree.
+ * @param currentGroup The id of the current scope.
  * @return Value The Module-typed value representing the loaded library.
  */
 
-Value ModuleNode::evaluate(SymbolContainer& env, const std::string& currentGroup) const {
-    if (originalName == "vcore") {
-        setupVCore(env, StringPool::instance());
-    }
-
-    if (originalName == "vglib") {
-        setupVGLib(env, StringPool::instance());
-    }
-
-    if (originalName == "vmem") {
-        setupVMem(env, StringPool::instance());
+Value ModuleNode::evaluate(SymbolContainer& env, ScopeId currentGroup) const {
+    if (const NativeModule* native = NativeRegistry::find(originalName)) {
+        NativeRegistry::load(*native, env);
     }
 
-    if (originalName == "vmath") {
-        setupVMath(env, StringPool::instance());
-    }
-    
     // TODO this shit clashes with group names
     env[currentGroup][moduleId] = Value(moduleId, originalName, true); 
     
     return env[currentGroup][moduleId];
 }
 
-Value ImportNode::evaluate(SymbolContainer& env, const std::string& currentGroup) const {
-    const std::string& source = FileUtils::readFile(filePath);
-    auto tokens = tokenize(source);
-    Parser parser(std::move(tokens));
-    auto externalAst = parser.parseProgram();
+Value ImportNode::evaluate(SymbolContainer& env, ScopeId currentGroup) const {
+    const ModuleCache::Module& module = ModuleCache::instance().load(filePath);
+    const SymbolContainer& exports = module.exports;
 
-    SymbolContainer externalEnv;
-
-    try {
-        externalAst->evaluate(externalEnv, "global");
-        std::cout << "[DEBUG] External file '" << filePath << "' evaluated successfully.\n";
-    } catch (const std::runtime_error& e) {
-        throw std::runtime_error("In " + filePath + ": " + e.what());
+    for (auto const& [id, val] : exports.at(SymbolContainer::GLOBAL)) {
+        env[SymbolContainer::GLOBAL][id] = val;
     }
 
-    for (auto const& [id, val] : externalEnv["global"]) {
-        env["global"][id] = val;
-    }
-
-    for (auto it = externalEnv.begin(); it != externalEnv.end(); ++it) {
-        const std::string& scopeName = it->first;
-
-        if (scopeName == "global") continue;
+    // groups and modules of the file are copied below global, or below the alias
+    ScopeId into = alias.empty() ? SymbolContainer::GLOBAL : env.child(SymbolContainer::GLOBAL, StringPool::intern(alias));
 
-        std::string finalScopeName;
-        if (alias.empty()) {
-            finalScopeName = scopeName;
-        } else {
-            if (scopeName.rfind("global.", 0) == 0) {
-                finalScopeName = "global." + alias + "." + scopeName.substr(7);
-            } else {
-                finalScopeName = alias + "." + scopeName;
-            }
+    std::function<void(ScopeId, ScopeId)> transfer = [&](ScopeId from, ScopeId to) {
+        for (const auto& [nameId, fromChild] : exports.childrenOf(from)) {
+            ScopeId toChild = env.child(to, nameId);
+            env[toChild] = exports.at(fromChild);
+            transfer(fromChild, toChild);
         }
+    };
+    transfer(SymbolContainer::GLOBAL, into);
 
-        std::cout << "[DEBUG] Transferring Scope: " << scopeName << " -> " << finalScopeName 
-                  << " (" << it->second.size() << " symbols)\n";
-
-        env[finalScopeName] = std::move(it->second);
-    }
-
-    for (const auto& modName : externalEnv.getDeployedList()) {
+    for (const auto& modName : exports.getDeployedList()) {
         const std::string& targetMod = alias.empty() ? modName : alias + "." + modName;
         env.deploy(targetMod);
     }
@@ -776,10 +1488,10 @@ Value ImportNode::evaluate(SymbolContainer& env, const std::string& currentGroup
     return Value(true);
 }
 
-Value DeployNode::evaluate(SymbolContainer& env, const std::string& currentGroup) const {
+Value DeployNode::evaluate(SymbolContainer& env, ScopeId currentGroup) const {
     uint32_t modId = StringPool::instance().intern(moduleName); 
 
-    if (env["global"].find(modId) == env["global"].end()) {
+    if (env[SymbolContainer::GLOBAL].find(modId) == env[SymbolContainer::GLOBAL].end()) {
         throw std::runtime_error("Runtime Error: Module '" + moduleName + "' not found [ line " + std::to_string(lineNumber) + " ]");
     }
 
@@ -788,18 +1500,16 @@ Value DeployNode::evaluate(SymbolContainer& env, const std::string& currentGroup
     return Value(true); 
 }
 
-Value DismissNode::evaluate(SymbolContainer& env, const std::string& currentGroup) const {
+Value DismissNode::evaluate(SymbolContainer& env, ScopeId currentGroup) const {
     bool erasedSomething = false;
     uint32_t nameId = StringPool::instance().intern(originalName);
 
-    if (env.erase("global." + originalName)) erasedSomething = true;
+    if (env.drop(SymbolContainer::GLOBAL, nameId)) erasedSomething = true;
 
-    if (env.count(currentGroup)) {
-        if (env[currentGroup].erase(nameId)) erasedSomething = true;
-    }
+    if (env[currentGroup].erase(nameId)) erasedSomething = true;
 
-    if (currentGroup != "global" && env.count("global")) {
-        if (env["global"].erase(nameId)) erasedSomething = true;
+    if (currentGroup != SymbolContainer::GLOBAL) {
+        if (env[SymbolContainer::GLOBAL].erase(nameId)) erasedSomething = true;
     }
 
     if (erasedSomething) return Value();
@@ -807,14 +1517,9 @@ Value DismissNode::evaluate(SymbolContainer& env, const std::string& currentGrou
     throw std::runtime_error("Module Error: Could not dismiss '" + originalName + "' [ line " + std::to_string(lineNumber) + " ]");
 }
 
-std::string resolvePath(std::vector<std::string> scope, const std::string& currentGroup) {
-    if (scope.empty()) {
-        return currentGroup;
-    }
-    
-    std::string path = "global";
-    for (const auto& segment : scope) {
-        path += "." + segment;
-    }
+std::vector<uint32_t> internPath(const std::vector<std::string>& scope) {
+    std::vector<uint32_t> path;
+    path.reserve(scope.size());
+    for (const auto& segment : scope) path.emplace_back(StringPool::instance().intern(segment));
     return path;
 }
\ No newline at end of file
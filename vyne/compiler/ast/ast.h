@@ -3,6 +3,7 @@
 #include <string>
 #include <memory>
 #include <unordered_map>
+#include <deque>
 #include <vector>
 #include <set>
 #include <algorithm>
@@ -17,58 +18,289 @@
 #include "../types.h"
 #include "../../utils/file_utils.h"
 #include "value.h"
+#include "arena.h"
+#include "frame.h"
+#include "memo.h"
 
 class Emitter;
 class Parser;
+class FlatProgram;
 struct Value;
 class ASTNode;
-using SymbolTable = std::unordered_map<uint32_t, Value>;
+
+using NodeList = ArenaList<ASTNode*>;
+
+struct MapEntryNode {
+    ASTNode* key;
+    ASTNode* value;
+};
+/**
+ * @brief Variables of one scope, keyed by interned name.
+ * * @details A thin wrapper over unordered_map so that every change to the set
+ * of keys (a new variable, an erase, clearing, replacing or dropping a scope)
+ * bumps one shape version. Values live in map nodes that never move, so a
+ * resolved Value* stays valid for as long as the version does (see VariableSlot).
+ */
+class SymbolTable {
+    using Map = std::unordered_map<uint32_t, Value>;
+    Map vars;
+
+    // counted per thread: the threads of a parallel loop only change scopes
+    // of their own and never use cached slots (see SymbolContainer::WorkerState)
+    static inline thread_local uint64_t shapeVersion = 0;
+
+public:
+    using iterator = Map::iterator;
+    using const_iterator = Map::const_iterator;
+
+    SymbolTable() = default;
+    SymbolTable(const SymbolTable& other) : vars(other.vars) { ++shapeVersion; }
+    SymbolTable(SymbolTable&& other) noexcept : vars(std::move(other.vars)) { other.vars.clear(); ++shapeVersion; }
+    ~SymbolTable() { if (!vars.empty()) ++shapeVersion; }
+
+    SymbolTable& operator=(const SymbolTable& other) { vars = other.vars; ++shapeVersion; return *this; }
+    SymbolTable& operator=(SymbolTable&& other) noexcept { vars = std::move(other.vars); other.vars.clear(); ++shapeVersion; return *this; }
+
+    Value& operator[](uint32_t id) {
+        auto [it, inserted] = vars.try_emplace(id);
+        if (inserted) ++shapeVersion;
+        return it->second;
+    }
+
+    iterator find(uint32_t id) { return vars.find(id); }
+    const_iterator find(uint32_t id) const { return vars.find(id); }
+    size_t count(uint32_t id) const { return vars.count(id); }
+
+    iterator begin() { return vars.begin(); }
+    iterator end() { return vars.end(); }
+    const_iterator begin() const { return vars.begin(); }
+    const_iterator end() const { return vars.end(); }
+
+    size_t erase(uint32_t id) {
+        size_t erased = vars.erase(id);
+        if (erased) ++shapeVersion;
+        return erased;
+    }
+
+    iterator erase(const_iterator it) {
+        ++shapeVersion;
+        return vars.erase(it);
+    }
+
+    void clear() {
+        if (!vars.empty()) ++shapeVersion;
+        vars.clear();
+    }
+
+    size_t size() const { return vars.size(); }
+    bool empty() const { return vars.empty(); }
+
+    static uint64_t version() { return shapeVersion; }
+    /// For changes the table can't see itself (a scope id being recycled).
+    static void invalidate() { ++shapeVersion; }
+};
+
+using ScopeId = uint32_t;
+
+class SymbolContainer;
+
+/**
+ * @brief Where one variable reference resolved to the last time it ran.
+ * * @details Kept (mutable) inside the referencing node. It is reused as long
+ * as the reference runs in the same scope of the same container and no scope
+ * changed its keys since, otherwise the reference resolves again.
+ */
+struct VariableSlot {
+    const SymbolContainer* env = nullptr;
+    ScopeId scope = 0;
+    uint64_t version = 0;
+    Value* value = nullptr;
+    bool inGroup = false;   // found in the starting scope itself, not in one of its parents
+};
+
+class FunctionCallNode;
+
+/**
+ * @brief A call in tail position, waiting for the current call to end.
+ * * @details `return f(x)` inside a sub evaluates f and its arguments, parks
+ * them here and returns. The invoke() loop of the caller then leaves the
+ * current frame and runs f in its place, so tail recursion doesn't grow
+ * the C++ stack.
+ */
+struct TailCall {
+    const FunctionCallNode* call = nullptr;
+    Value callee;
+    std::vector<Value> args;
+};
+
+/**
+ * @brief Every scope of a running program, as a tree of integer-identified nodes.
+ * * @details Scope 0 is "global". Groups and modules are named children of the
+ * scope they are declared in (keyed by interned name), function calls open
+ * anonymous children that are closed again when they return. Lookups walk the
+ * parent links up to global, so entering or leaving a scope never builds or
+ * hashes a string. Closed ids are recycled.
+ * * Dotted paths like "global.vcore" only exist for display, see name().
+ */
 class SymbolContainer {
-    std::unordered_map<std::string, SymbolTable> table;
+public:
+    static constexpr ScopeId GLOBAL = 0;
+    static constexpr ScopeId NONE = UINT32_MAX;
+
+    /**
+     * @brief What a thread running the body of a `parallel` loop keeps to itself.
+     * @details While a WorkerThread is alive on a thread, that thread calls subs
+     * on its own frame stack and tail call slot, and resolves every variable
+     * afresh instead of through the VariableSlot cached in the node, which all
+     * threads share. Only the thread that started the loop writes the caches.
+     */
+    struct WorkerState {
+        FrameStack frames;
+        TailCall tail;
+    };
+
+    class WorkerThread {
+        WorkerState* previous;
+    public:
+        explicit WorkerThread(WorkerState& state) : previous(worker) { worker = &state; }
+        ~WorkerThread() { worker = previous; }
+        WorkerThread(const WorkerThread&) = delete;
+        WorkerThread& operator=(const WorkerThread&) = delete;
+    };
+
+    /// Whether the calling thread is running the body of a parallel loop.
+    static bool onWorker() { return worker != nullptr; }
+
+    struct Scope {
+        uint32_t nameId = 0;
+        ScopeId parent = NONE;
+        bool live = false;
+        SymbolTable vars;
+        std::unordered_map<uint32_t, ScopeId> children; // named children (groups, modules)
+    };
+
+private:
+    std::deque<Scope> scopes; // growing a deque never moves the scopes already in it
+    std::vector<ScopeId> freeIds;
     
     std::vector<std::string> deployedModules;
+    FrameStack callFrames;
+    TailCall pendingTail;
 
-public:
-    SymbolTable& operator[](const std::string& key) { return table[key]; }
+    static inline thread_local WorkerState* worker = nullptr;
 
-    auto find(const std::string& key) { return table.find(key); }
-    auto begin() { return table.begin(); } 
-    auto begin() const { return table.begin(); }
-    
-    auto end() { return table.end(); }
-    auto end() const { return table.end(); }
+    ScopeId allocate(ScopeId parent, uint32_t nameId);
+    void release(ScopeId id);
+
+public:
+    SymbolContainer();
+
+    SymbolTable& operator[](ScopeId id) { return scopes[id].vars; }
+    /// Activation records of the user functions currently running.
+    FrameStack& frames() { return worker ? worker->frames : callFrames; }
+    /// The tail call the innermost running function returned with, if any.
+    TailCall& tailCall() { return worker ? worker->tail : pendingTail; }
+    const SymbolTable& at(ScopeId id) const { return scopes[id].vars; }
+
+    ScopeId parentOf(ScopeId id) const { return scopes[id].parent; }
+    const std::unordered_map<uint32_t, ScopeId>& childrenOf(ScopeId id) const { return scopes[id].children; }
+
+    /// Named child of `parent`, created on first use.
+    ScopeId child(ScopeId parent, uint32_t nameId);
+    /// Named child of `parent`, or NONE.
+    ScopeId findChild(ScopeId parent, uint32_t nameId) const;
+
+    /// Follows a `a.b` qualifier down from global, or NONE if part of it doesn't exist.
+    ScopeId findPath(const std::vector<uint32_t>& path) const;
+    /// Same, creating the missing scopes.
+    ScopeId makePath(const std::vector<uint32_t>& path);
+
+    /// Opens an anonymous scope below `parent` (a function call). Must be closed again.
+    ScopeId open(ScopeId parent, uint32_t nameId) { return allocate(parent, nameId); }
+    void close(ScopeId id) { release(id); }
+
+    /// Removes a named child of `parent` together with everything below it.
+    bool drop(ScopeId parent, uint32_t nameId);
+
+    /// Dotted display name, e.g. "global.tracker".
+    std::string name(ScopeId id) const;
+
+    /// Calls fn(id, table) for every open scope.
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (ScopeId id = 0; id < scopes.size(); ++id) {
+            if (scopes[id].live) fn(id, scopes[id].vars);
+        }
+    }
 
     void deploy(const std::string& moduleName) {
-        SymbolTable& globalScope = table["global"];
-    
         deployedModules.emplace_back(moduleName);
     }
 
-    size_t count(const std::string& key) const {
-        return table.count(key);
+    /**
+     * @brief Finds the stored value of a variable without copying it.
+     * * @details Looks in the given scope first, then in each parent up to global.
+     * Never creates a scope.
+     * @return Value* Pointer to the stored value, or nullptr if not found.
+     */
+    Value* lookup(ScopeId scope, uint32_t id) {
+        for (ScopeId at = scope; at != NONE; at = scopes[at].parent) {
+            auto& vars = scopes[at].vars;
+            auto varIt = vars.find(id);
+            if (varIt != vars.end()) return &varIt->second;
+        }
+        return nullptr;
     }
 
-    bool contains(const std::string& key) const {
-        return table.find(key) != table.end();
-    }
+    /**
+     * @brief Same as lookup(), memoised in the caller's VariableSlot.
+     * * @details A hit costs two integer compares instead of probing one table
+     * per scope between `scope` and global.
+     */
+    Value* lookup(VariableSlot& slot, ScopeId scope, uint32_t id) {
+        if (worker) return lookup(scope, id);
+        if (slot.env == this && slot.version == SymbolTable::version() && slot.scope == scope) return slot.value;
+
+        slot.env = this;
+        slot.scope = scope;
+        slot.version = SymbolTable::version();
+        slot.value = nullptr;
+        slot.inGroup = false;
+
+        if (scope == NONE) return nullptr;
+
+        auto& vars = scopes[scope].vars;
+        auto varIt = vars.find(id);
+        if (varIt != vars.end()) {
+            slot.value = &varIt->second;
+            slot.inGroup = true;
+            return slot.value;
+        }
 
-    const std::vector<std::string>& getDeployedList() const {
-        return deployedModules;
+        slot.value = scopes[scope].parent != NONE ? lookup(scopes[scope].parent, id) : nullptr;
+        return slot.value;
     }
 
-    size_t erase(const std::string& key) {
-        return table.erase(key);
-    }
+    /// Same, but only a variable stored in `scope` itself, not in one of its parents.
+    Value* lookupIn(VariableSlot& slot, ScopeId scope, uint32_t id) {
+        if (worker) {
+            if (scope == NONE) return nullptr;
+            auto varIt = scopes[scope].vars.find(id);
+            return varIt != scopes[scope].vars.end() ? &varIt->second : nullptr;
+        }
 
-    const SymbolTable& at(const std::string& key) const {
-        return table.at(key);
+        Value* val = lookup(slot, scope, id);
+        return slot.inGroup ? val : nullptr;
     }
 
-    size_t size() const { return table.size(); }
-    
-    bool empty() const { return table.empty(); }
+    const std::vector<std::string>& getDeployedList() const {
+        return deployedModules;
+    }
 };
 
+/// Interns each segment of a `a.b` scope qualifier.
+std::vector<uint32_t> internPath(const std::vector<std::string>& scope);
+
 // exception signals
 struct ReturnException {
     Value value;
@@ -92,6 +324,7 @@ enum class NodeType {
     UNARY,
 
     ARRAY,
+    MAP,
     RANGE,
     INDEX_ACCESS,
 
@@ -127,38 +360,57 @@ public:
 
     NodeType type() const { return nodeType; }
     virtual VType getStaticType() const { return VType::Unknown; }
-    virtual Value evaluate(SymbolContainer& env, const std::string& currentGroup = "global") const = 0;
+    virtual Value evaluate(SymbolContainer& env, ScopeId currentGroup = SymbolContainer::GLOBAL) const = 0;
+    /**
+     * @brief Evaluates the node for reading only.
+     * @details Variables and indexed elements hand out their stored value in place,
+     * anything else is evaluated into `scratch`. The pointer is only good until
+     * something else runs: an assignment, call or dismiss may move or free it.
+     */
+    virtual const Value* evaluateRef(SymbolContainer& env, ScopeId currentGroup, Value& scratch) const {
+        scratch = evaluate(env, currentGroup);
+        return &scratch;
+    }
     virtual void compile(Emitter& e) const = 0;
+    /// Binds local variables to frame slots, see FrameLayout. Leaves have nothing to bind.
+    virtual void resolveLocals(FrameLayout&) {}
+    /// Flags the `return f(...)` statements reachable from here as tail calls.
+    virtual void markTailCalls() {}
 };
 
 class ProgramNode : public ASTNode {
 public:
-    std::vector<std::shared_ptr<ASTNode>> statements;
+    NodeList statements;
 
-    ProgramNode(std::vector<std::shared_ptr<ASTNode>> stmts) 
-        : ASTNode(NodeType::PROGRAM), statements(std::move(stmts)) {}
+    ProgramNode(NodeList stmts) 
+        : ASTNode(NodeType::PROGRAM), statements(stmts) {}
 
-    Value evaluate(SymbolContainer& env, const std::string& currentGroup = "global") const override;
+    Value evaluate(SymbolContainer& env, ScopeId currentGroup = SymbolContainer::GLOBAL) const override;
     void compile(Emitter& e) const override;
+    void resolveLocals(FrameLayout& frame) override;
 };
 
 class GroupNode : public ASTNode {
     const std::string groupName;
-    std::vector<std::unique_ptr<ASTNode>> statements;
+    uint32_t groupId;
+    NodeList statements;
 public:
-    GroupNode(std::string name, std::vector<std::unique_ptr<ASTNode>> stmts)
-        : ASTNode(NodeType::GROUP), groupName(name), statements(std::move(stmts)) {
+    GroupNode(std::string name, NodeList stmts)
+        : ASTNode(NodeType::GROUP), groupName(name), groupId(StringPool::intern(name)), statements(stmts) {
     }
 
-    Value evaluate(SymbolContainer& env, const std::string& currentGroup = "global") const override;
+    Value evaluate(SymbolContainer& env, ScopeId currentGroup = SymbolContainer::GLOBAL) const override;
     void compile(Emitter& e) const override;
+    void resolveLocals(FrameLayout& frame) override;
 };
 
 class NumberNode : public ASTNode {
+    friend class FlatProgram;
+
     double value;
 public:
     NumberNode(double val) : ASTNode(NodeType::NUMBER), value(val) {}
-    Value evaluate(SymbolContainer& env, const std::string& currentGroup = "global") const override;
+    Value evaluate(SymbolContainer& env, ScopeId currentGroup = SymbolContainer::GLOBAL) const override;
     void compile(Emitter& e) const override;
     VType getStaticType() const override { return VType::Number; }
 };
@@ -168,6 +420,9 @@ class VariableNode : public ASTNode {
     std::string originalName; 
     std::vector<std::string> specificGroup;
     VType explicitType;
+    std::vector<uint32_t> pathIds;
+    mutable VariableSlot slot;
+    uint32_t frameSlot = FrameLayout::NO_SLOT;
 
 public:
     VariableNode(uint32_t id, std::string name, VType et = VType::Unknown, std::vector<std::string> group = {})
@@ -175,10 +430,21 @@ public:
         nameId(id), 
         originalName(std::move(name)), 
         explicitType(std::move(et)),
-        specificGroup(std::move(group)) {}
+        specificGroup(std::move(group)) {
+        pathIds = internPath(specificGroup);
+    }
 
-    Value evaluate(SymbolContainer& env, const std::string& currentGroup = "global") const override;
+    Value evaluate(SymbolContainer& env, ScopeId currentGroup = SymbolContainer::GLOBAL) const override;
+    const Value* evaluateRef(SymbolContainer& env, ScopeId currentGroup, Value& scratch) const override;
     void compile(Emitter& e) const override;
+    void resolveLocals(FrameLayout& frame) override;
+
+    /// The stored value, read in place. nullptr if the variable doesn't exist.
+    Value* resolve(SymbolContainer& env, ScopeId currentGroup) const;
+    /// Same, but only if it is stored in currentGroup itself (not qualified, not a global seen through the fallback).
+    Value* resolveLocal(SymbolContainer& env, ScopeId currentGroup) const;
+    /// Creates the variable where an unqualified write puts it: its frame slot or currentGroup.
+    void store(SymbolContainer& env, ScopeId currentGroup, Value val) const;
 
     const std::vector<std::string>& getScope() const { return specificGroup; }
     uint32_t getNameId() const { return nameId; }
@@ -186,47 +452,84 @@ public:
     VType getStaticType() const override { return explicitType; }
 };
 
+class BinOpNode;
+
 class AssignmentNode : public ASTNode {
+    friend class FlatProgram;
+
     uint32_t identifierId;
     std::string originalName;
-    std::unique_ptr<ASTNode> rhs;
-    std::unique_ptr<ASTNode> indexExpr;
+    ASTNode* rhs;
+    ASTNode* indexExpr;
     std::vector<std::string> scopePath;
     bool isConstant;
     VType expectedType;
+    const BinOpNode* selfAppend = nullptr;
+    std::vector<uint32_t> pathIds;
+    mutable VariableSlot slot;
+    uint32_t frameSlot = FrameLayout::NO_SLOT;
+
+    const BinOpNode* detectSelfAppend() const;
+    ScopeId targetGroup(SymbolContainer& env, ScopeId currentGroup) const { return scopePath.empty() ? currentGroup : env.makePath(pathIds); }
+    Value* existing(SymbolContainer& env, ScopeId currentGroup) const;
 
 public:
     AssignmentNode(uint32_t id, 
                    std::string on, 
-                   std::unique_ptr<ASTNode> rhs_ptr, 
+                   ASTNode* rhs_ptr, 
                    bool ic,
                    VType vt,
                    std::vector<std::string> path = {},
-                   std::unique_ptr<ASTNode> idx_ptr = nullptr)
+                   ASTNode* idx_ptr = nullptr)
         : ASTNode(NodeType::ASSIGNMENT),
           identifierId(id), 
           originalName(std::move(on)), 
-          rhs(std::move(rhs_ptr)), 
-          indexExpr(std::move(idx_ptr)),
+          rhs(rhs_ptr), 
+          indexExpr(idx_ptr),
           scopePath(std::move(path)),
           isConstant(ic),
-          expectedType(std::move(vt)) {}
+          expectedType(std::move(vt)) {
+        selfAppend = detectSelfAppend();
+        pathIds = internPath(scopePath);
+    }
 
     void compile(Emitter& e) const override;
-    Value evaluate(SymbolContainer& env, const std::string& currentGroup = "global") const override;
+
+    void resolveLocals(FrameLayout& frame) override;
+    Value evaluate(SymbolContainer& env, ScopeId currentGroup = SymbolContainer::GLOBAL) const override;
+
+    /// Type checks and stores an already computed right-hand side.
+    Value assign(SymbolContainer& env, ScopeId currentGroup, Value val) const;
 };
 
 class BinOpNode : public ASTNode {
+    friend class FlatProgram;
+
     VTokenType op;
-    std::unique_ptr<ASTNode> left;
-    std::unique_ptr<ASTNode> right;
+    ASTNode* left;
+    ASTNode* right;
+    bool borrowLeft;    // left is a stored value that evaluating right can't change
+
+    static bool readsOnly(const ASTNode* node);
+
 public:
-    BinOpNode(VTokenType op, std::unique_ptr<ASTNode> l, std::unique_ptr<ASTNode> r)
-        : ASTNode(NodeType::BINARY_OP), op(op), left(std::move(l)), right(std::move(r)) {
+    BinOpNode(VTokenType op, ASTNode* l, ASTNode* r)
+        : ASTNode(NodeType::BINARY_OP), op(op), left(l), right(r) {
+        borrowLeft = (l->type() == NodeType::VARIABLE || l->type() == NodeType::INDEX_ACCESS) && readsOnly(r);
     }
     
-    Value evaluate(SymbolContainer& env, const std::string& currentGroup = "global") const override;
+    Value evaluate(SymbolContainer& env, ScopeId currentGroup = SymbolContainer::GLOBAL) const override;
     void compile(Emitter& e) const override;
+    void resolveLocals(FrameLayout& frame) override;
+
+    /// Applies the operator, a temporary left array is extended in place.
+    Value apply(Value l, const Value& r) const;
+    /// Applies the operator without taking either operand.
+    Value combine(const Value& l, const Value& r) const;
+
+    VTokenType getOp() const { return op; }
+    const ASTNode* getLeft() const { return left; }
+    const ASTNode* getRight() const { return right; }
 
     VType getStaticType() const override {
         switch(op) {
@@ -251,47 +554,60 @@ public:
 
 class PostFixNode : public ASTNode {
     VTokenType op;
-    std::unique_ptr<ASTNode> left;
+    ASTNode* left;
 public:
-    PostFixNode(VTokenType op, std::unique_ptr<ASTNode> lhs)
-        : ASTNode(NodeType::POSTFIX), op(op), left(std::move(lhs)) {}
+    PostFixNode(VTokenType op, ASTNode* lhs)
+        : ASTNode(NodeType::POSTFIX), op(op), left(lhs) {}
     
-    Value evaluate(SymbolContainer& env, const std::string& currentGroup = "global") const override;
+    Value evaluate(SymbolContainer& env, ScopeId currentGroup = SymbolContainer::GLOBAL) const override;
     void compile(Emitter& e) const override;
+    void resolveLocals(FrameLayout& frame) override;
     VType getStaticType() const override { return VType::Number; }
 };
 
 class UnaryNode : public ASTNode {
+    friend class FlatProgram;
+
     VTokenType op;
-    std::unique_ptr<ASTNode> right;
+    ASTNode* right;
 
 public: 
-    UnaryNode(VTokenType op, std::unique_ptr<ASTNode> rhs)
-        : ASTNode(NodeType::UNARY), op(op), right(std::move(rhs)) {}
+    UnaryNode(VTokenType op, ASTNode* rhs)
+        : ASTNode(NodeType::UNARY), op(op), right(rhs) {}
     
-    Value evaluate(SymbolContainer& env, const std::string& currentGroup = "global") const override;
+    Value evaluate(SymbolContainer& env, ScopeId currentGroup = SymbolContainer::GLOBAL) const override;
+    Value apply(const Value& val) const;
     void compile(Emitter& e) const override;
+    void resolveLocals(FrameLayout& frame) override;
     VType getStaticType() const override { return VType::Number; }
+
+    const ASTNode* getRight() const { return right; }
 };   
 
 class BuiltInCallNode : public ASTNode {
+    friend class FlatProgram;
+
     std::string funcName;
-    std::vector<std::unique_ptr<ASTNode>> arguments;
+    NodeList arguments;
 public:
-    BuiltInCallNode(std::string name, std::vector<std::unique_ptr<ASTNode>> args) 
+    BuiltInCallNode(std::string name, NodeList args) 
         : ASTNode(NodeType::BUILTIN_CALL), 
-        funcName(std::move(name)), arguments(std::move(args)) {}
+        funcName(std::move(name)), arguments(args) {}
 
-    Value evaluate(SymbolContainer& env, const std::string& currentGroup) const override;
+    Value evaluate(SymbolContainer& env, ScopeId currentGroup) const override;
+    Value call(std::vector<Value>& argValues) const;
     void compile(Emitter& e) const override;
+    void resolveLocals(FrameLayout& frame) override;
 };
 
 class StringNode : public ASTNode {
+    friend class FlatProgram;
+
     std::string text;
 public:
     StringNode(std::string t) : ASTNode(NodeType::STRING), text(std::move(t)) {}
     
-    Value evaluate(SymbolContainer& env, const std::string& currentGroup = "global") const override {
+    Value evaluate(SymbolContainer& env, ScopeId currentGroup = SymbolContainer::GLOBAL) const override {
         return Value(text);
     }
 
@@ -300,11 +616,13 @@ public:
 };
 
 class BooleanNode : public ASTNode {
+    friend class FlatProgram;
+
     bool condition;
 public :
     BooleanNode(bool c) : ASTNode(NodeType::BOOLEAN), condition(c) {}
 
-    Value evaluate(SymbolContainer& env, const std::string& currentGroup = "global") const override {
+    Value evaluate(SymbolContainer& env, ScopeId currentGroup = SymbolContainer::GLOBAL) const override {
         return Value(condition);
     };
     void compile(Emitter& e) const override;
@@ -312,121 +630,226 @@ public :
 };
 
 class ArrayNode : public ASTNode {
-    std::vector<std::unique_ptr<ASTNode>> elements;
+    friend class FlatProgram;
+
+    NodeList elements;
 public:
-    ArrayNode(std::vector<std::unique_ptr<ASTNode>> elm) : ASTNode(NodeType::ARRAY), elements(std::move(elm)) {}
+    ArrayNode(NodeList elm) : ASTNode(NodeType::ARRAY), elements(elm) {}
 
-    Value evaluate(SymbolContainer& env, const std::string& currentGroup = "global") const override;
+    Value evaluate(SymbolContainer& env, ScopeId currentGroup = SymbolContainer::GLOBAL) const override;
     void compile(Emitter& e) const override;
+    void resolveLocals(FrameLayout& frame) override;
     VType getStaticType() const override { return VType::Array; }
 };
 
+class MapNode : public ASTNode {
+    ArenaList<MapEntryNode> entries;
+public:
+    MapNode(ArenaList<MapEntryNode> e)
+        : ASTNode(NodeType::MAP), entries(e) {}
+
+    Value evaluate(SymbolContainer& env, ScopeId currentGroup = SymbolContainer::GLOBAL) const override;
+    void compile(Emitter& e) const override;
+    void resolveLocals(FrameLayout& frame) override;
+    VType getStaticType() const override { return VType::Map; }
+};
+
 class RangeNode : public ASTNode {
-    std::unique_ptr<ASTNode> left;
-    std::unique_ptr<ASTNode> right;
+    ASTNode* left;
+    ASTNode* right;
 public:
-    RangeNode(std::unique_ptr<ASTNode> l, std::unique_ptr<ASTNode> r) :
+    RangeNode(ASTNode* l, ASTNode* r) :
     ASTNode(NodeType::RANGE),
-    left(std::move(l)), right(std::move(r)) {}
+    left(l), right(r) {}
 
-    Value evaluate(SymbolContainer& env, const std::string& currentGroup = "global") const override;
+    Value evaluate(SymbolContainer& env, ScopeId currentGroup = SymbolContainer::GLOBAL) const override;
     void compile(Emitter& e) const override;
+    void resolveLocals(FrameLayout& frame) override;
     VType getStaticType() const override { return VType::Array; }
 };
 
 class IndexAccessNode : public ASTNode {
+    friend class FlatProgram;
+
     uint32_t nameId;
     std::string originalName;
     std::vector<std::string> scope;
-    std::unique_ptr<ASTNode> index;
+    ASTNode* index;
+    std::vector<uint32_t> pathIds;
+    mutable VariableSlot slot;
+    uint32_t frameSlot = FrameLayout::NO_SLOT;
 
 public :
-    IndexAccessNode(uint32_t n, std::string on, std::vector<std::string> s, std::unique_ptr<ASTNode> idx)
-        : ASTNode(NodeType::INDEX_ACCESS), nameId(n), originalName(std::move(on)), scope(std::move(s)), index(std::move(idx)) {}
+    IndexAccessNode(uint32_t n, std::string on, std::vector<std::string> s, ASTNode* idx)
+        : ASTNode(NodeType::INDEX_ACCESS), nameId(n), originalName(std::move(on)), scope(std::move(s)), index(idx) {
+        pathIds = internPath(scope);
+    }
 
-    Value evaluate(SymbolContainer& env, const std::string& currentGroup) const override;
+    Value evaluate(SymbolContainer& env, ScopeId currentGroup) const override;
+    const Value* evaluateRef(SymbolContainer& env, ScopeId currentGroup, Value& scratch) const override;
+
+    Value evaluateIndex(SymbolContainer& env, ScopeId currentGroup) const { return index->evaluate(env, currentGroup); }
+    const ASTNode* getIndex() const { return index; }
+    Value element(SymbolContainer& env, ScopeId currentGroup, const Value& idxVal) const;
+    /// The element in place, packed numbers are copied into `scratch`.
+    const Value* elementRef(SymbolContainer& env, ScopeId currentGroup, const Value& idxVal, Value& scratch) const;
+    Value* resolveElement(SymbolContainer& env, ScopeId currentGroup, const Value& idxVal) const;
+    /// The indexed variable itself, nullptr if it doesn't exist.
+    Value* container(SymbolContainer& env, ScopeId currentGroup) const;
+    /// Same, but only if it is a local or lives in currentGroup itself.
+    Value* localContainer(SymbolContainer& env, ScopeId currentGroup) const;
+    uint32_t getNameId() const { return nameId; }
+    const std::vector<std::string>& getScope() const { return scope; }
     void compile(Emitter& e) const override;
+    void resolveLocals(FrameLayout& frame) override;
 };
 
 class FunctionNode : public ASTNode {
+    friend class FlatProgram;
+
     std::string targetModule;
     uint32_t funcNameId;
     std::string originalName;
     std::vector<uint32_t> parameterIds;
-    std::vector<std::shared_ptr<ASTNode>> body;
+    NodeList body;
+    AstArena* owner;
+    bool memo;
+    uint32_t frameSize;
+    bool pure;
+    std::vector<uint32_t> callees;
 
 public:
     FunctionNode(std::string tm, uint32_t n,std::string on, std::vector<uint32_t> pid, 
-                 std::vector<std::shared_ptr<ASTNode>> body)
-        : ASTNode(NodeType::FUNCTION), targetModule(tm), funcNameId(n), originalName(std::move(on)), parameterIds(std::move(pid)), body(std::move(body)) {}
+                 NodeList body, AstArena* arena, bool memo = false)
+        : ASTNode(NodeType::FUNCTION), targetModule(tm), funcNameId(n), originalName(std::move(on)), parameterIds(std::move(pid)), body(body), owner(arena), memo(memo) {
+        FrameLayout layout = FrameLayout::build(parameterIds, body);
+        frameSize = layout.frameSize();
+        pure = layout.isPure();
+        callees = layout.callees();
+
+        for (ASTNode* stmt : body) stmt->markTailCalls();
+    }
 
-    Value evaluate(SymbolContainer& env, const std::string& currentGroup) const override;
+    Value evaluate(SymbolContainer& env, ScopeId currentGroup) const override;
     void compile(Emitter& e) const override;
+    void resolveLocals(FrameLayout& frame) override;
     VType getStaticType() const override { return VType::Function; }
 };
 
 class FunctionCallNode : public ASTNode {
+    friend class FlatProgram;
+
     uint32_t funcNameId;
     std::string originalName;
-    std::vector<std::unique_ptr<ASTNode>> arguments;
+    NodeList arguments;
+    mutable VariableSlot slot;
 
 public:
-    FunctionCallNode(uint32_t fn, std::string name, std::vector<std::unique_ptr<ASTNode>> args)
-        : ASTNode(NodeType::FUNCTION_CALL), funcNameId(fn), originalName(std::move(name)), arguments(std::move(args)) {}
-
-    Value evaluate(SymbolContainer& env, const std::string& currentGroup = "global") const override;
+    FunctionCallNode(uint32_t fn, std::string name, NodeList args)
+        : ASTNode(NodeType::FUNCTION_CALL), funcNameId(fn), originalName(std::move(name)), arguments(args) {}
+
+    Value evaluate(SymbolContainer& env, ScopeId currentGroup = SymbolContainer::GLOBAL) const override;
+
+    /// Looks the callee up in the global scope, throws if it isn't a function.
+    Value callee(SymbolContainer& env) const;
+    /// Runs the callee and the tail calls it ends in. Bodies known to `flat` run flattened.
+    Value invoke(SymbolContainer& env, const Value& funcVal, std::vector<Value>& args, const FlatProgram* flat = nullptr) const;
+    /// Evaluates the callee and arguments and parks them in env.tailCall().
+    void prepareTail(SymbolContainer& env, ScopeId currentGroup) const;
+    /// Runs the tail call a finished body left in env.tailCall(), if any, and returns the final result.
+    static Value finishTail(SymbolContainer& env, Value result, const FlatProgram* flat = nullptr);
     void compile(Emitter& e) const override;
+    void resolveLocals(FrameLayout& frame) override;
+
+private:
+    /// invoke() for `memo sub`: answers from the cache or runs and stores the result.
+    Value invokeMemo(SymbolContainer& env, const Value& funcVal, std::vector<Value>& args, const FlatProgram* flat) const;
+    /// One call: pushes its frame (or call scope), runs the body, leaves again.
+    Value enter(SymbolContainer& env, const Value& funcVal, std::vector<Value>& args, const FlatProgram* flat) const;
 };
 
 class ReturnNode : public ASTNode {
-    std::unique_ptr<ASTNode> expression;
+    friend class FlatProgram;
+
+    ASTNode* expression;
+    bool tailCall = false;
 public:
-    ReturnNode(std::unique_ptr<ASTNode> expr) : ASTNode(NodeType::RETURN), expression(std::move(expr)) {}
+    ReturnNode(ASTNode* expr) : ASTNode(NodeType::RETURN), expression(expr) {}
 
-    Value evaluate(SymbolContainer& env, const std::string& currentGroup = "global") const override;
+    Value evaluate(SymbolContainer& env, ScopeId currentGroup = SymbolContainer::GLOBAL) const override;
     void compile(Emitter& e) const override;
+    void resolveLocals(FrameLayout& frame) override;
+    void markTailCalls() override;
 };
 
 class MethodCallNode : public ASTNode {
-    std::unique_ptr<ASTNode> receiver;
+    ASTNode* receiver;
     std::string methodName;
-    std::vector<std::unique_ptr<ASTNode>> arguments;
+    uint32_t methodId;
+    NodeList arguments;
+
+    /// Whether the named receiver is a local or lives in currentGroup itself.
+    bool ownsReceiver(SymbolContainer& env, ScopeId currentGroup) const;
 
 public:
-    MethodCallNode(std::unique_ptr<ASTNode> recv, std::string method, 
-                   std::vector<std::unique_ptr<ASTNode>> args)
+    MethodCallNode(ASTNode* recv, std::string method, 
+                   NodeList args)
         : ASTNode(NodeType::METHOD_CALL),
-        receiver(std::move(recv)), methodName(std::move(method)), arguments(std::move(args)) {}
+        receiver(recv), methodName(std::move(method)), methodId(StringPool::instance().intern(methodName)), arguments(args) {}
 
-    Value evaluate(SymbolContainer& env, const std::string& currentGroup = "global") const override;
+    Value evaluate(SymbolContainer& env, ScopeId currentGroup = SymbolContainer::GLOBAL) const override;
     void compile(Emitter& e) const override;
+    void resolveLocals(FrameLayout& frame) override;
 };
 
 class WhileNode : public ASTNode {
-    std::unique_ptr<ASTNode> condition;
-    std::unique_ptr<ASTNode> body;
+    friend class FlatProgram;
+
+    ASTNode* condition;
+    ASTNode* body;
 
 public:
-    WhileNode(std::unique_ptr<ASTNode> c, std::unique_ptr<ASTNode> b)
-        : ASTNode(NodeType::WHILE), condition(std::move(c)), body(std::move(b)) {}
+    WhileNode(ASTNode* c, ASTNode* b)
+        : ASTNode(NodeType::WHILE), condition(c), body(b) {}
 
-    Value evaluate(SymbolContainer& env, const std::string& currentGroup = "global") const override;
+    Value evaluate(SymbolContainer& env, ScopeId currentGroup = SymbolContainer::GLOBAL) const override;
     void compile(Emitter& e) const override;
+    void resolveLocals(FrameLayout& frame) override;
+    void markTailCalls() override { body->markTailCalls(); }
 };
 
 class ForNode : public ASTNode {
     enum class ForMode { LOOP, COLLECT, FILTER, EVERY, UNIQUE };
-    std::unique_ptr<ASTNode> iterable;
-    std::unique_ptr<ASTNode> body;
+    ASTNode* iterable;
+    ASTNode* body;
     std::string iteratorName;
     ForMode mode;
 
+    // `parallel` loops only, from FrameLayout::inspect over the body
+    bool parallel;
+    bool isolated = true;
+    std::vector<uint32_t> assigned;   // names the body assigns, the iterator aside
+    std::vector<uint32_t> callees;
+
+    Value evaluateParallel(SymbolContainer& env, ScopeId currentGroup, const ArrayData& elements) const;
+
 public:
-    ForNode(std::unique_ptr<ASTNode> i, std::unique_ptr<ASTNode> b, std::string in, ForMode m)
-        : ASTNode(NodeType::FOR), iterable(std::move(i)), body(std::move(b)), iteratorName(std::move(in)), mode(m) {}
+    ForNode(ASTNode* i, ASTNode* b, std::string in, ForMode m, bool par = false)
+        : ASTNode(NodeType::FOR), iterable(i), body(b), iteratorName(std::move(in)), mode(m), parallel(par) {
+        if (!parallel) return;
+
+        uint32_t itId = StringPool::intern(iteratorName);
+        FrameLayout layout = FrameLayout::inspect(itId, body);
+        isolated = layout.isIsolated();
+        callees = layout.callees();
+        for (uint32_t id : layout.locals()) {
+            if (id != itId) assigned.push_back(id);
+        }
+    }
 
-    Value evaluate(SymbolContainer& env, const std::string& currentGroup = "global") const override;
+    Value evaluate(SymbolContainer& env, ScopeId currentGroup = SymbolContainer::GLOBAL) const override;
     void compile(Emitter& e) const override;
+    void resolveLocals(FrameLayout& frame) override;
 
     static ForMode getForMode(const std::string& modeStr){
         if (modeStr == "collect") return ForNode::ForMode::COLLECT;
@@ -439,13 +862,15 @@ public:
 
 class BlockNode : public ASTNode {
 public:
-    std::vector<std::shared_ptr<ASTNode>> statements;
+    NodeList statements;
 
-    BlockNode(std::vector<std::shared_ptr<ASTNode>> stmts) 
-        : ASTNode(NodeType::BLOCK), statements(std::move(stmts)) {}
+    BlockNode(NodeList stmts) 
+        : ASTNode(NodeType::BLOCK), statements(stmts) {}
 
-    Value evaluate(SymbolContainer& env, const std::string& currentGroup = "global") const override;
+    Value evaluate(SymbolContainer& env, ScopeId currentGroup = SymbolContainer::GLOBAL) const override;
     void compile(Emitter& e) const override;
+    void resolveLocals(FrameLayout& frame) override;
+    void markTailCalls() override { for (ASTNode* stmt : statements) stmt->markTailCalls(); }
 };
 
 class ModuleNode : public ASTNode {
@@ -455,8 +880,9 @@ public:
 
     ModuleNode(uint32_t mId, std::string mName) : ASTNode(NodeType::MODULE), moduleId(mId), originalName(std::move(mName)) {}
 
-    Value evaluate(SymbolContainer& env, const std::string& currentGroup = "global") const override;
+    Value evaluate(SymbolContainer& env, ScopeId currentGroup = SymbolContainer::GLOBAL) const override;
     void compile(Emitter& e) const override;
+    void resolveLocals(FrameLayout& frame) override;
     VType getStaticType() const override { return VType::Module; }
 };
 
@@ -467,8 +893,9 @@ public:
     ImportNode(std::string path, std::string al = "") 
         : ASTNode(NodeType::IMPORT), filePath(std::move(path)), alias(std::move(al)) {}
 
-    Value evaluate(SymbolContainer& env, const std::string& currentGroup = "global") const override;
+    Value evaluate(SymbolContainer& env, ScopeId currentGroup = SymbolContainer::GLOBAL) const override;
     void compile(Emitter& e) const override;
+    void resolveLocals(FrameLayout& frame) override;
 };
 
 class DeployNode : public ASTNode {
@@ -476,9 +903,11 @@ class DeployNode : public ASTNode {
 public:
     DeployNode(std::string name) : ASTNode(NodeType::DEPLOY), moduleName(std::move(name)) {}
 
-    Value evaluate(SymbolContainer& env, const std::string& currentGroup = "global") const override;
+    Value evaluate(SymbolContainer& env, ScopeId currentGroup = SymbolContainer::GLOBAL) const override;
     
     void compile(Emitter& e) const override {}
+    
+    void resolveLocals(FrameLayout& frame) override;
 };
 
 class DismissNode : public ASTNode {
@@ -488,28 +917,34 @@ public:
 
     DismissNode(uint32_t mId, std::string mName) : ASTNode(NodeType::DISMISS), moduleId(mId), originalName(std::move(mName)) {}
 
-    Value evaluate(SymbolContainer& env, const std::string& currentGroup = "global") const override;
+    Value evaluate(SymbolContainer& env, ScopeId currentGroup = SymbolContainer::GLOBAL) const override;
     void compile(Emitter& e) const override;
+    void resolveLocals(FrameLayout& frame) override;
 };
 
 class IfNode : public ASTNode {
 public:
-    std::unique_ptr<ASTNode> condition;
-    std::unique_ptr<ASTNode> body;
-    std::unique_ptr<ASTNode> elseBody;
+    ASTNode* condition;
+    ASTNode* body;
+    ASTNode* elseBody;
 
-    IfNode(std::unique_ptr<ASTNode> c, std::unique_ptr<ASTNode> b, std::unique_ptr<ASTNode> eb = nullptr) : 
-    ASTNode(NodeType::IF), condition(std::move(c)), body(std::move(b)), elseBody(std::move(eb)) {}
+    IfNode(ASTNode* c, ASTNode* b, ASTNode* eb = nullptr) : 
+    ASTNode(NodeType::IF), condition(c), body(b), elseBody(eb) {}
 
-    Value evaluate(SymbolContainer& env, const std::string& currentGroup = "global") const override;
+    Value evaluate(SymbolContainer& env, ScopeId currentGroup = SymbolContainer::GLOBAL) const override;
     void compile(Emitter& e) const override;
+    void resolveLocals(FrameLayout& frame) override;
+    void markTailCalls() override {
+        body->markTailCalls();
+        if (elseBody) elseBody->markTailCalls();
+    }
 };
 
 // exception structs
 struct BreakNode : public ASTNode {
     BreakNode() : ASTNode(NodeType::BREAK) {}
 
-    Value evaluate(SymbolContainer& env, const std::string& currentGroup = "global") const override {
+    Value evaluate(SymbolContainer& env, ScopeId currentGroup = SymbolContainer::GLOBAL) const override {
         throw BreakException();
     }
     void compile(Emitter& e) const override;
@@ -518,10 +953,9 @@ struct BreakNode : public ASTNode {
 struct ContinueNode : public ASTNode {
     ContinueNode() : ASTNode(NodeType::CONTINUE) {}
 
-    Value evaluate(SymbolContainer& env, const std::string& currentGroup = "global") const override {
+    Value evaluate(SymbolContainer& env, ScopeId currentGroup = SymbolContainer::GLOBAL) const override {
         throw ContinueException();
     }
     void compile(Emitter& e) const override;
 };
 
-std::string resolvePath(std::vector<std::string> scope, const std::string& currentGroup = "global");
\ No newline at end of file
@@ -0,0 +1,329 @@
+#include "flat_program.h"
+
+FlatProgram::FlatProgram(const ProgramNode& program) {
+    root = flatten(&program);
+}
+
+Value FlatProgram::run(SymbolContainer& env, ScopeId currentGroup) const {
+    Signal signal = Signal::None;
+    Value result = eval(root, env, currentGroup, signal);
+    rethrow(signal, result);
+    return result;
+}
+
+Value FlatProgram::runBody(const Span& body, SymbolContainer& env, ScopeId currentGroup) const {
+    Signal signal = Signal::None;
+    Value result = runList(body, env, currentGroup, signal);
+    if (signal == Signal::Return) return result;
+
+    // a stray break/continue leaves the function the same way the tree's exceptions do
+    rethrow(signal, result);
+    return result;
+}
+
+void FlatProgram::rethrow(Signal signal, Value& val) {
+    switch (signal) {
+        case Signal::Return:   throw ReturnException{std::move(val)};
+        case Signal::Break:    throw BreakException();
+        case Signal::Continue: throw ContinueException();
+        default: break;
+    }
+}
+
+const FlatProgram::Span* FlatProgram::bodyOf(const FunctionData& func) const {
+    auto it = functionBodies.find(func.body.begin());
+    return it == functionBodies.end() ? nullptr : &it->second;
+}
+
+uint32_t FlatProgram::emit(const ASTNode* source, uint32_t a, uint32_t b, uint32_t c) {
+    FlatNode node;
+    node.type = source->type();
+    node.delegate = false;
+    node.op = VTokenType::End;
+    node.a = a;
+    node.b = b;
+    node.c = c;
+    node.source = source;
+
+    nodes.emplace_back(node);
+    return static_cast<uint32_t>(nodes.size() - 1);
+}
+
+uint32_t FlatProgram::emitDelegate(const ASTNode* source) {
+    uint32_t index = emit(source);
+    nodes[index].delegate = true;
+    return index;
+}
+
+uint32_t FlatProgram::emitConstant(const ASTNode* source, Value val) {
+    constants.emplace_back(std::move(val));
+    return emit(source, static_cast<uint32_t>(constants.size() - 1));
+}
+
+FlatProgram::Span FlatProgram::flattenList(const NodeList& list) {
+    // children are flattened first (post-order), their indices are then stored contiguously
+    std::vector<uint32_t> children;
+    children.reserve(list.size());
+    for (const ASTNode* child : list) children.emplace_back(flatten(child));
+
+    Span span;
+    span.offset = static_cast<uint32_t>(lists.size());
+    span.count = static_cast<uint32_t>(children.size());
+    lists.insert(lists.end(), children.begin(), children.end());
+    return span;
+}
+
+uint32_t FlatProgram::flatten(const ASTNode* node) {
+    switch (node->type()) {
+        case NodeType::NUMBER:
+            return emitConstant(node, Value(static_cast<const NumberNode*>(node)->value));
+
+        case NodeType::STRING:
+            return emitConstant(node, Value(static_cast<const StringNode*>(node)->text));
+
+        case NodeType::BOOLEAN:
+            return emitConstant(node, Value(static_cast<const BooleanNode*>(node)->condition));
+
+        case NodeType::VARIABLE:
+        case NodeType::BREAK:
+        case NodeType::CONTINUE:
+            return emit(node);
+
+        case NodeType::ASSIGNMENT: {
+            auto* assign = static_cast<const AssignmentNode*>(node);
+            // in-place appends and indexed stores keep their dedicated tree path
+            if (assign->selfAppend || assign->indexExpr) return emitDelegate(node);
+            return emit(node, flatten(assign->rhs));
+        }
+
+        case NodeType::BINARY_OP: {
+            auto* bin = static_cast<const BinOpNode*>(node);
+            uint32_t l = flatten(bin->left);
+            uint32_t r = flatten(bin->right);
+
+            uint32_t index = emit(node, l, r);
+            nodes[index].op = bin->op;
+            return index;
+        }
+
+        case NodeType::UNARY:
+            return emit(node, flatten(static_cast<const UnaryNode*>(node)->right));
+
+        case NodeType::INDEX_ACCESS:
+            return emit(node, flatten(static_cast<const IndexAccessNode*>(node)->index));
+
+        case NodeType::RETURN: {
+            auto* ret = static_cast<const ReturnNode*>(node);
+            return emit(node, flatten(ret->expression), ret->tailCall ? TAIL : NONE);
+        }
+
+        case NodeType::ARRAY: {
+            Span span = flattenList(static_cast<const ArrayNode*>(node)->elements);
+            return emit(node, span.offset, span.count);
+        }
+
+        case NodeType::BUILTIN_CALL: {
+            Span span = flattenList(static_cast<const BuiltInCallNode*>(node)->arguments);
+            return emit(node, span.offset, span.count);
+        }
+
+        case NodeType::FUNCTION_CALL: {
+            Span span = flattenList(static_cast<const FunctionCallNode*>(node)->arguments);
+            return emit(node, span.offset, span.count);
+        }
+
+        case NodeType::PROGRAM: {
+            Span span = flattenList(static_cast<const ProgramNode*>(node)->statements);
+            return emit(node, span.offset, span.count);
+        }
+
+        case NodeType::BLOCK: {
+            Span span = flattenList(static_cast<const BlockNode*>(node)->statements);
+            return emit(node, span.offset, span.count);
+        }
+
+        case NodeType::IF: {
+            auto* branch = static_cast<const IfNode*>(node);
+            uint32_t condition = flatten(branch->condition);
+            uint32_t body = flatten(branch->body);
+            uint32_t elseBody = branch->elseBody ? flatten(branch->elseBody) : NONE;
+            return emit(node, condition, body, elseBody);
+        }
+
+        case NodeType::WHILE: {
+            auto* loop = static_cast<const WhileNode*>(node);
+            uint32_t condition = flatten(loop->condition);
+            uint32_t body = flatten(loop->body);
+            return emit(node, condition, body);
+        }
+
+        case NodeType::FUNCTION: {
+            // defining the function stays on the tree, calls to it run the flat body
+            auto* func = static_cast<const FunctionNode*>(node);
+            functionBodies[func->body.begin()] = flattenList(func->body);
+            return emitDelegate(node);
+        }
+
+        default:
+            return emitDelegate(node);
+    }
+}
+
+Value FlatProgram::runList(const Span& list, SymbolContainer& env, ScopeId currentGroup, Signal& signal) const {
+    Value lastValue;
+    for (uint32_t i = 0; i < list.count; ++i) {
+        lastValue = Value();
+        lastValue = eval(lists[list.offset + i], env, currentGroup, signal);
+        if (signal != Signal::None) break;
+    }
+    return lastValue;
+}
+
+Value FlatProgram::eval(uint32_t index, SymbolContainer& env, ScopeId currentGroup, Signal& signal) const {
+    const FlatNode& node = nodes[index];
+    if (node.delegate) return node.source->evaluate(env, currentGroup);
+
+    switch (node.type) {
+        case NodeType::NUMBER:
+        case NodeType::STRING:
+        case NodeType::BOOLEAN:
+            return constants[node.a];
+
+        case NodeType::VARIABLE:
+            return static_cast<const VariableNode*>(node.source)->VariableNode::evaluate(env, currentGroup);
+
+        case NodeType::ASSIGNMENT:
+            return static_cast<const AssignmentNode*>(node.source)->assign(env, currentGroup, eval(node.a, env, currentGroup, signal));
+
+        case NodeType::BINARY_OP: {
+            auto* bin = static_cast<const BinOpNode*>(node.source);
+            Value lScratch;
+            Value rScratch;
+
+            if (node.op == VTokenType::And) {
+                if (!evalRef(node.a, env, currentGroup, signal, lScratch)->isTruthy()) return Value(0.0);
+                return Value(evalRef(node.b, env, currentGroup, signal, rScratch)->isTruthy() ? 1.0 : 0.0);
+            }
+
+            if (node.op == VTokenType::Or) {
+                if (evalRef(node.a, env, currentGroup, signal, lScratch)->isTruthy()) return Value(1.0);
+                return Value(evalRef(node.b, env, currentGroup, signal, rScratch)->isTruthy() ? 1.0 : 0.0);
+            }
+
+            if (bin->borrowLeft) {
+                const Value* l = evalRef(node.a, env, currentGroup, signal, lScratch);
+                return bin->combine(*l, *evalRef(node.b, env, currentGroup, signal, rScratch));
+            }
+
+            Value l = eval(node.a, env, currentGroup, signal);
+            return bin->apply(std::move(l), *evalRef(node.b, env, currentGroup, signal, rScratch));
+        }
+
+        case NodeType::UNARY:
+            return static_cast<const UnaryNode*>(node.source)->apply(eval(node.a, env, currentGroup, signal));
+
+        case NodeType::INDEX_ACCESS:
+            return static_cast<const IndexAccessNode*>(node.source)->element(env, currentGroup, eval(node.a, env, currentGroup, signal));
+
+        case NodeType::ARRAY: {
+            std::vector<Value> results;
+            results.reserve(node.b);
+            for (uint32_t i = 0; i < node.b; ++i) results.emplace_back(eval(lists[node.a + i], env, currentGroup, signal));
+            return Value(std::move(results));
+        }
+
+        case NodeType::BUILTIN_CALL: {
+            std::vector<Value> argValues;
+            argValues.reserve(node.b);
+            for (uint32_t i = 0; i < node.b; ++i) argValues.emplace_back(eval(lists[node.a + i], env, currentGroup, signal));
+            return static_cast<const BuiltInCallNode*>(node.source)->call(argValues);
+        }
+
+        case NodeType::FUNCTION_CALL: {
+            auto* call = static_cast<const FunctionCallNode*>(node.source);
+            Value funcVal = call->callee(env);
+
+            std::vector<Value> argValues;
+            argValues.reserve(node.b);
+            for (uint32_t i = 0; i < node.b; ++i) argValues.emplace_back(eval(lists[node.a + i], env, currentGroup, signal));
+            return call->invoke(env, funcVal, argValues, this);
+        }
+
+        case NodeType::RETURN: {
+            if (node.b == TAIL && !nodes[node.a].delegate) {
+                // same as FUNCTION_CALL, but the call is left to the caller's invoke()
+                const FlatNode& callNode = nodes[node.a];
+                auto* call = static_cast<const FunctionCallNode*>(callNode.source);
+                TailCall& tail = env.tailCall();
+                Value funcVal = call->callee(env);
+
+                std::vector<Value> argValues;
+                argValues.reserve(callNode.b);
+                for (uint32_t i = 0; i < callNode.b; ++i) argValues.emplace_back(eval(lists[callNode.a + i], env, currentGroup, signal));
+
+                tail.call = call;
+                tail.callee = std::move(funcVal);
+                tail.args = std::move(argValues);
+                signal = Signal::Return;
+                return Value();
+            }
+
+            Value result = eval(node.a, env, currentGroup, signal);
+            signal = Signal::Return;
+            return result;
+        }
+
+        case NodeType::BREAK:
+            signal = Signal::Break;
+            return Value();
+
+        case NodeType::CONTINUE:
+            signal = Signal::Continue;
+            return Value();
+
+        case NodeType::PROGRAM:
+        case NodeType::BLOCK:
+            return runList(Span{node.a, node.b}, env, currentGroup, signal);
+
+        case NodeType::IF:
+            if (eval(node.a, env, currentGroup, signal).isTruthy()) return eval(node.b, env, currentGroup, signal);
+            if (node.c != NONE) return eval(node.c, env, currentGroup, signal);
+            return Value();
+
+        case NodeType::WHILE: {
+            Value lastResult;
+            while (eval(node.a, env, currentGroup, signal).isTruthy()) {
+                try {
+                    lastResult = Value();
+                    lastResult = eval(node.b, env, currentGroup, signal);
+                } catch (const BreakException&) { break; }
+                catch (const ContinueException&) { continue; }
+
+                if (signal == Signal::Return) break;
+                if (signal == Signal::Break) { signal = Signal::None; break; }
+                if (signal == Signal::Continue) signal = Signal::None;
+            }
+            return lastResult;
+        }
+
+        default:
+            return node.source->evaluate(env, currentGroup);
+    }
+}
+
+const Value* FlatProgram::evalRef(uint32_t index, SymbolContainer& env, ScopeId currentGroup, Signal& signal, Value& scratch) const {
+    const FlatNode& node = nodes[index];
+
+    if (!node.delegate) {
+        if (node.type == NodeType::VARIABLE) {
+            return static_cast<const VariableNode*>(node.source)->VariableNode::evaluateRef(env, currentGroup, scratch);
+        }
+        if (node.type == NodeType::INDEX_ACCESS) {
+            Value idxVal = eval(node.a, env, currentGroup, signal);
+            return static_cast<const IndexAccessNode*>(node.source)->elementRef(env, currentGroup, idxVal, scratch);
+        }
+    }
+
+    scratch = eval(index, env, currentGroup, signal);
+    return &scratch;
+}
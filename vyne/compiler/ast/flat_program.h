@@ -0,0 +1,77 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+#include "ast.h"
+
+/**
+ * @brief Compact, index-based encoding of a parsed program for the `--ast` path.
+ * * @details The pointer tree is flattened once after parsing into a single
+ * contiguous array of FlatNode in post-order (children always come before
+ * their parent). Children are 32-bit indices and lists of children live in
+ * a shared index pool, so evaluating is a switch over a tag instead of a
+ * virtual call through a cold pointer per node.
+ * * Nodes that have no flat form yet (methods, loops over sequences, groups,
+ * modules, ...) are kept as a delegate entry that calls back into the tree's
+ * evaluate(). The operators themselves are shared with the tree through
+ * BinOpNode::apply, AssignmentNode::assign, etc., so both paths behave the same.
+ * * `return`, `break` and `continue` inside flat code travel back up as a
+ * Signal next to the result instead of as C++ exceptions, which makes calls
+ * and loops much cheaper. They only turn into the tree's exceptions where
+ * they leave flat code (see runBody and run).
+ * * @note The FlatProgram points into the tree, it must not outlive the ProgramNode.
+ */
+class FlatProgram {
+public:
+    static constexpr uint32_t NONE = UINT32_MAX;
+    static constexpr uint32_t TAIL = 1;    // RETURN whose expression is a call in tail position
+
+    /// A run of child indices inside the list pool.
+    struct Span {
+        uint32_t offset = 0;
+        uint32_t count = 0;
+    };
+
+    explicit FlatProgram(const ProgramNode& root);
+
+    Value run(SymbolContainer& env, ScopeId currentGroup = SymbolContainer::GLOBAL) const;
+
+    /// Flattened body of a function defined in this program, or nullptr.
+    const Span* bodyOf(const FunctionData& func) const;
+
+    /// Runs a function body, a `return` ends it with its value.
+    Value runBody(const Span& body, SymbolContainer& env, ScopeId currentGroup) const;
+
+    size_t size() const { return nodes.size(); }
+
+private:
+    enum class Signal : uint8_t { None, Return, Break, Continue };
+
+    struct FlatNode {
+        NodeType type;
+        bool delegate;          // evaluate through `source` instead
+        VTokenType op;          // BINARY_OP
+        uint32_t a = NONE;      // first child, constant index or list offset
+        uint32_t b = NONE;      // second child, list count or RETURN's TAIL flag
+        uint32_t c = NONE;      // third child (IF else branch)
+        const ASTNode* source;  // tree node, owns names/line numbers and shared logic
+    };
+
+    std::vector<FlatNode> nodes;
+    std::vector<uint32_t> lists;
+    std::vector<Value> constants;
+    std::unordered_map<const ASTNode* const*, Span> functionBodies;
+    uint32_t root = NONE;
+
+    uint32_t flatten(const ASTNode* node);
+    Span flattenList(const NodeList& list);
+    uint32_t emit(const ASTNode* source, uint32_t a = NONE, uint32_t b = NONE, uint32_t c = NONE);
+    uint32_t emitDelegate(const ASTNode* source);
+    uint32_t emitConstant(const ASTNode* source, Value val);
+
+    Value eval(uint32_t index, SymbolContainer& env, ScopeId currentGroup, Signal& signal) const;
+    const Value* evalRef(uint32_t index, SymbolContainer& env, ScopeId currentGroup, Signal& signal, Value& scratch) const;
+    Value runList(const Span& list, SymbolContainer& env, ScopeId currentGroup, Signal& signal) const;
+    static void rethrow(Signal signal, Value& val);
+};
@@ -0,0 +1,260 @@
+#include "frame.h"
+#include "ast.h"
+
+#include <string>
+#include <unordered_set>
+
+Local* FrameStack::push(uint32_t size) {
+    frames.push_back({chunk, top, current, size});
+
+    if (chunks.empty() || top + size > chunks[chunk].capacity) {
+        size_t next = chunks.empty() ? 0 : chunk + 1;
+        if (next == chunks.size()) chunks.emplace_back();
+
+        // chunks above the top are unused, a too small one can simply be replaced
+        Chunk& target = chunks[next];
+        if (target.capacity < size) {
+            target.capacity = size > CHUNK_SIZE ? size : CHUNK_SIZE;
+            target.slots = std::make_unique<Local[]>(target.capacity);
+        }
+
+        chunk = next;
+        top = 0;
+    }
+
+    current = chunks[chunk].slots.get() + top;
+    top += size;
+    return current;
+}
+
+void FrameStack::pop() {
+    const Saved saved = frames.back();
+    frames.pop_back();
+
+    for (Local* slot = current; slot != current + saved.size; ++slot) *slot = Local();
+
+    chunk = saved.chunk;
+    top = saved.top;
+    current = saved.base;
+}
+
+FrameLayout FrameLayout::build(const std::vector<uint32_t>& params, const ArenaList<ASTNode*>& body) {
+    FrameLayout layout;
+    for (uint32_t id : params) layout.declare(id);
+    // arguments are stored by position, a repeated name would shift them
+    if (layout.slots.size() != params.size()) layout.unsupported();
+
+    for (ASTNode* stmt : body) layout.visit(stmt);
+    if (!layout.supported) return layout;
+
+    layout.phase = Phase::Bind;
+    for (ASTNode* stmt : body) layout.visit(stmt);
+
+    return layout;
+}
+
+FrameLayout FrameLayout::inspect(uint32_t iteratorId, ASTNode* body) {
+    FrameLayout layout;
+    layout.declare(iteratorId);
+    layout.visit(body);
+    return layout;
+}
+
+std::vector<uint32_t> FrameLayout::locals() const {
+    std::vector<uint32_t> ids(slots.size());
+    for (const auto& [id, slot] : slots) ids[slot] = id;
+    return ids;
+}
+
+uint32_t FrameLayout::frameSize() const {
+    return supported ? static_cast<uint32_t>(slots.size()) : NO_FRAME;
+}
+
+void FrameLayout::visit(ASTNode* node) {
+    // an unsupported body is still walked to the end for the purity check
+    if (node) node->resolveLocals(*this);
+}
+
+void FrameLayout::read(uint32_t nameId) {
+    if (phase == Phase::Collect && !assigned.count(nameId)) pure = false;
+}
+
+void FrameLayout::calls(uint32_t nameId) {
+    if (phase == Phase::Collect) calledIds.emplace_back(nameId);
+}
+
+void FrameLayout::declare(uint32_t nameId) {
+    if (phase != Phase::Collect) return;
+
+    slots.try_emplace(nameId, static_cast<uint32_t>(slots.size()));
+    assigned.insert(nameId);
+}
+
+void FrameLayout::join(const Assigned& other) {
+    for (auto it = assigned.begin(); it != assigned.end();) {
+        if (other.count(*it)) ++it;
+        else it = assigned.erase(it);
+    }
+}
+
+uint32_t FrameLayout::slotOf(uint32_t nameId) const {
+    if (phase == Phase::Collect) return NO_SLOT;
+
+    auto it = slots.find(nameId);
+    return it == slots.end() ? NO_SLOT : it->second;
+}
+
+// --- per node ---
+
+void ProgramNode::resolveLocals(FrameLayout& frame) {
+    for (ASTNode* stmt : statements) frame.visit(stmt);
+}
+
+void BlockNode::resolveLocals(FrameLayout& frame) {
+    for (ASTNode* stmt : statements) frame.visit(stmt);
+}
+
+void VariableNode::resolveLocals(FrameLayout& frame) {
+    if (specificGroup.empty()) {
+        frame.read(nameId);
+        frameSlot = frame.slotOf(nameId);
+    } else if (specificGroup.size() != 1 || specificGroup[0] != "vmath") {
+        // vmath only holds read-only constants, any other group can change
+        frame.impure();
+    }
+}
+
+void AssignmentNode::resolveLocals(FrameLayout& frame) {
+    frame.visit(rhs);
+    frame.visit(indexExpr);
+
+    if (!scopePath.empty()) {
+        frame.writes();
+        return;
+    }
+    frame.declare(identifierId);
+    frameSlot = frame.slotOf(identifierId);
+}
+
+void PostFixNode::resolveLocals(FrameLayout& frame) {
+    // `i++` reads the name, then always writes the current scope, so it is a local from here on
+    frame.visit(left);
+    if (left->type() == NodeType::VARIABLE) {
+        auto* var = static_cast<VariableNode*>(left);
+        if (var->getScope().empty()) frame.declare(var->getNameId());
+    }
+}
+
+void IndexAccessNode::resolveLocals(FrameLayout& frame) {
+    frame.visit(index);
+    if (!scope.empty()) {
+        frame.impure();
+        return;
+    }
+    frame.read(nameId);
+    frameSlot = frame.slotOf(nameId);
+}
+
+void BinOpNode::resolveLocals(FrameLayout& frame) {
+    frame.visit(left);
+    frame.visit(right);
+}
+
+void UnaryNode::resolveLocals(FrameLayout& frame) {
+    frame.visit(right);
+}
+
+void RangeNode::resolveLocals(FrameLayout& frame) {
+    frame.visit(left);
+    frame.visit(right);
+}
+
+void ArrayNode::resolveLocals(FrameLayout& frame) {
+    for (ASTNode* element : elements) frame.visit(element);
+}
+
+void MapNode::resolveLocals(FrameLayout& frame) {
+    for (const auto& [key, value] : entries) {
+        frame.visit(key);
+        frame.visit(value);
+    }
+}
+
+void BuiltInCallNode::resolveLocals(FrameLayout& frame) {
+    if (funcName == "out") frame.writes();
+    for (ASTNode* arg : arguments) frame.visit(arg);
+}
+
+void FunctionCallNode::resolveLocals(FrameLayout& frame) {
+    frame.calls(funcNameId);
+    for (ASTNode* arg : arguments) frame.visit(arg);
+}
+
+void MethodCallNode::resolveLocals(FrameLayout& frame) {
+    // vmath natives are plain functions of their arguments, other modules may not be
+    bool mathCall = false;
+    if (receiver->type() == NodeType::VARIABLE) {
+        auto* var = static_cast<VariableNode*>(receiver);
+        mathCall = var->getScope().empty() && var->getOriginalName() == "vmath";
+    }
+
+    if (!mathCall) frame.visit(receiver);
+    for (ASTNode* arg : arguments) frame.visit(arg);
+
+    // anything but these changes the receiver, fine for a local or a temporary
+    static const std::unordered_set<std::string> readers = {"size", "keys", "get", "has"};
+    if (mathCall || readers.count(methodName)) return;
+
+    if (receiver->type() == NodeType::VARIABLE) {
+        auto* var = static_cast<VariableNode*>(receiver);
+        if (!var->getScope().empty() || !frame.isLocal(var->getNameId())) frame.writes();
+    } else if (receiver->type() == NodeType::INDEX_ACCESS) {
+        auto* access = static_cast<IndexAccessNode*>(receiver);
+        if (!access->getScope().empty() || !frame.isLocal(access->getNameId())) frame.writes();
+    }
+}
+
+void ReturnNode::resolveLocals(FrameLayout& frame) {
+    frame.visit(expression);
+}
+
+// a name is assigned after the if only when both arms assign it
+void IfNode::resolveLocals(FrameLayout& frame) {
+    frame.visit(condition);
+
+    FrameLayout::Assigned before = frame.assignedSoFar();
+    frame.visit(body);
+    FrameLayout::Assigned afterBody = frame.assignedSoFar();
+
+    frame.restore(std::move(before));
+    frame.visit(elseBody);
+    frame.join(afterBody);
+}
+
+// the body may not run at all, what it assigns isn't assigned after the loop
+void WhileNode::resolveLocals(FrameLayout& frame) {
+    frame.visit(condition);
+
+    FrameLayout::Assigned before = frame.assignedSoFar();
+    frame.visit(body);
+    frame.restore(std::move(before));
+}
+
+// the iterator is written into the current (call) scope, so it is a local as well
+void ForNode::resolveLocals(FrameLayout& frame) {
+    frame.unsupported();
+    frame.visit(iterable);
+
+    FrameLayout::Assigned before = frame.assignedSoFar();
+    frame.declare(StringPool::instance().intern(iteratorName));
+    frame.visit(body);
+    frame.restore(std::move(before));
+}
+
+// these write outside the call or open scopes of their own
+void GroupNode::resolveLocals(FrameLayout& frame)    { frame.unsupported(); frame.writes(); }
+void FunctionNode::resolveLocals(FrameLayout& frame) { frame.unsupported(); frame.writes(); }
+void ModuleNode::resolveLocals(FrameLayout& frame)   { frame.unsupported(); frame.writes(); }
+void ImportNode::resolveLocals(FrameLayout& frame)   { frame.unsupported(); frame.writes(); }
+void DeployNode::resolveLocals(FrameLayout& frame)   { frame.unsupported(); frame.writes(); }
+void DismissNode::resolveLocals(FrameLayout& frame)  { frame.unsupported(); frame.writes(); }
@@ -0,0 +1,134 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "value.h"
+#include "arena.h"
+
+class ASTNode;
+
+/**
+ * @brief One local variable slot of a call frame.
+ * * @details A slot exists for every name the function assigns, but it only
+ * shadows the enclosing scopes once it was actually assigned in this call,
+ * until then reads go through to them (same as a call scope without that key).
+ */
+struct Local {
+    Value value;
+    bool bound = false;
+};
+
+/**
+ * @brief Stack of activation records for user function calls.
+ * * @details Frames are carved out of large chunks by bumping an offset, a
+ * frame never straddles two chunks and chunks are never moved, so a Local*
+ * stays valid while its frame is alive. Popping resets the slots (dropping
+ * their references) and moves the offset back.
+ */
+class FrameStack {
+    struct Chunk {
+        std::unique_ptr<Local[]> slots;
+        size_t capacity = 0;
+    };
+
+    struct Saved {
+        size_t chunk;
+        size_t top;
+        Local* base;
+        uint32_t size;
+    };
+
+    static constexpr size_t CHUNK_SIZE = 4096;
+
+    std::vector<Chunk> chunks;
+    std::vector<Saved> frames;
+    size_t chunk = 0;   // chunk the top frame lives in
+    size_t top = 0;     // first free slot of that chunk
+    Local* current = nullptr;
+
+public:
+    Local* push(uint32_t size);
+    void pop();
+
+    /// Slots of the innermost call.
+    Local* base() const { return current; }
+    size_t depth() const { return frames.size(); }
+};
+
+/**
+ * @brief Assigns frame slots to the local variables of one function body.
+ * * @details Runs once when a `sub` is parsed. The first pass collects the
+ * locals (parameters, then every unqualified name the body assigns or
+ * increments), the second stores each one's slot index in the nodes that
+ * read or write it. Bodies that open scopes of their own (groups, `through`,
+ * nested subs, modules, dismiss) keep running in a call scope instead.
+ * * The collect pass also decides whether the body is pure: it only reads
+ * its own locals, writes nothing outside them, prints nothing and calls
+ * only other subs (listed in callees, checked when a `memo sub` first runs)
+ * and vmath. A name counts as local for a read once every path before it
+ * assigned the name. A name only one arm of an if assigns still reads the
+ * enclosing scope after the if.
+ * * It also notes whether the body is isolated: it changes nothing but its
+ * own locals (no scoped assignments, no `out`, no declarations, no mutating
+ * method calls on names from outside), which a `parallel` loop checks for
+ * its body with inspect().
+ * @see ASTNode::resolveLocals
+ */
+class FrameLayout {
+public:
+    static constexpr uint32_t NO_SLOT = UINT32_MAX;
+    static constexpr uint32_t NO_FRAME = UINT32_MAX;
+
+    static FrameLayout build(const std::vector<uint32_t>& params, const ArenaList<ASTNode*>& body);
+    /// Only the collect pass over a loop body, nothing is bound.
+    static FrameLayout inspect(uint32_t iteratorId, ASTNode* body);
+
+    using Assigned = std::unordered_set<uint32_t>;
+
+    void visit(ASTNode* node);
+    void declare(uint32_t nameId);
+
+    /// Names assigned on every path so far. Nodes whose children may not run
+    /// (if arms, loop bodies) save them first and restore or join them after.
+    Assigned assignedSoFar() const { return assigned; }
+    void restore(Assigned names) { assigned = std::move(names); }
+    /// Keeps only the names other has as well, where the arms of an if meet.
+    void join(const Assigned& other);
+    void unsupported() { supported = false; }
+
+    /// A read of an unqualified name, names not assigned on every path up to it make the body impure.
+    void read(uint32_t nameId);
+    /// A call of the sub named nameId.
+    void calls(uint32_t nameId);
+    void impure() { pure = false; }
+    /// A change of state outside the locals, also makes the body impure.
+    void writes() { pure = false; isolated = false; }
+
+    /// Slot of a local, NO_SLOT for names that aren't (or while still collecting).
+    uint32_t slotOf(uint32_t nameId) const;
+    /// Whether nameId is assigned on every path up to here.
+    bool isLocal(uint32_t nameId) const { return assigned.count(nameId) != 0; }
+
+    /// Number of slots the body needs per call, or NO_FRAME.
+    uint32_t frameSize() const;
+    bool isPure() const { return pure; }
+    bool isIsolated() const { return isolated; }
+    const std::vector<uint32_t>& callees() const { return calledIds; }
+    /// Names of the locals, in slot order.
+    std::vector<uint32_t> locals() const;
+
+private:
+    enum class Phase { Collect, Bind };
+
+    Phase phase = Phase::Collect;
+    bool supported = true;
+    bool pure = true;
+    bool isolated = true;
+    std::unordered_map<uint32_t, uint32_t> slots;
+    Assigned assigned;
+    std::vector<uint32_t> calledIds;
+};
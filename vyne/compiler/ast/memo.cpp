@@ -0,0 +1,117 @@
+#include "memo.h"
+#include "ast.h"
+
+#include <unordered_set>
+
+MemoStats MemoCache::counters;
+std::mutex MemoCache::sharing;
+
+size_t MemoCache::ArgsHash::operator()(const std::vector<Value>& args) const {
+    size_t seed = args.size();
+    for (const Value& arg : args) {
+        seed ^= arg.hash() + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+    }
+    return seed;
+}
+
+bool MemoCache::cacheable(const std::vector<Value>& args) {
+    for (const Value& arg : args) {
+        if (!arg.isHashable()) return false;
+    }
+    return true;
+}
+
+const Value* MemoCache::find(const std::vector<Value>& args) {
+    auto it = results.find(args);
+    if (it == results.end()) return nullptr;
+
+    counters.hits++;
+    return &it->second;
+}
+
+void MemoCache::store(std::vector<Value> args, const Value& result) {
+    counters.misses++;
+
+    if (results.size() >= LIMIT) {
+        results.clear();
+        counters.evictions++;
+    }
+    results.emplace(std::move(args), result);
+}
+
+bool MemoCache::findShared(const std::vector<Value>& args, Value& result) {
+    std::lock_guard<std::mutex> lock(sharing);
+    const Value* hit = find(args);
+    if (hit) result = *hit;
+    return hit != nullptr;
+}
+
+void MemoCache::storeShared(std::vector<Value> args, const Value& result) {
+    std::lock_guard<std::mutex> lock(sharing);
+    store(std::move(args), result);
+}
+
+// whether every callee name still resolves to the sub it did when func was verified
+static bool sameCallees(SymbolContainer& env, const FunctionData& func) {
+    static const std::shared_ptr<FunctionData> missing;
+    auto& global = env[SymbolContainer::GLOBAL];
+
+    for (const auto& [id, bound] : func.boundCallees) {
+        auto it = global.find(id);
+        const auto& now = it != global.end() && it->second.getType() == Value::FUNCTION ? it->second.asFunction() : missing;
+        // compares ownership, a sub freed since and one allocated at its address still differ
+        if (now.owner_before(bound) || bound.owner_before(now)) return false;
+    }
+    return true;
+}
+
+void MemoCache::verify(SymbolContainer& env, FunctionData& func, uint32_t nameId, int line) {
+    if (func.verified) {
+        if (sameCallees(env, func)) return;
+
+        func.verified = false;
+        func.memoCache->results.clear();
+    }
+
+    CalleeBindings reached;
+    uint32_t id = findImpure(env, {{&func, nameId}}, false, &reached);
+    if (id != ALL_PURE) {
+        const std::string& name = StringPool::instance().get(id);
+        std::string reason = id == nameId ? "it" : "it calls '" + name + "' which";
+
+        throw std::runtime_error("Runtime Error: Cannot memo '" + StringPool::instance().get(nameId) + "', " + reason +
+                                 " reads or changes state outside its own locals [ line " + std::to_string(line) + " ]");
+    }
+
+    func.boundCallees = std::move(reached);
+    func.verified = true;
+}
+
+uint32_t MemoCache::findImpure(SymbolContainer& env, std::vector<std::pair<const FunctionData*, uint32_t>> pending,
+                               bool framed, CalleeBindings* reached) {
+    std::unordered_set<const FunctionData*> seen;
+    std::unordered_set<uint32_t> named;
+
+    while (!pending.empty()) {
+        auto [current, id] = pending.back();
+        pending.pop_back();
+        if (!seen.insert(current).second) continue;
+
+        if (current->isNative || !current->pure) return id;
+        if (framed && current->frameSize == FrameLayout::NO_FRAME) return id;
+
+        auto& global = env[SymbolContainer::GLOBAL];
+        for (uint32_t callee : current->callees) {
+            auto it = global.find(callee);
+            bool found = it != global.end() && it->second.getType() == Value::FUNCTION;
+            if (reached && named.insert(callee).second) {
+                reached->emplace_back(callee, found ? it->second.asFunction() : nullptr);
+            }
+
+            // a missing callee fails when it is called, with its own error
+            if (!found) continue;
+            pending.emplace_back(it->second.asFunction().get(), callee);
+        }
+    }
+    return ALL_PURE;
+}
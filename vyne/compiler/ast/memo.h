@@ -0,0 +1,78 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "value.h"
+
+class SymbolContainer;
+
+struct MemoStats {
+    size_t hits = 0;        // calls answered from a cache
+    size_t misses = 0;      // calls that ran and were stored
+    size_t evictions = 0;   // caches dropped for reaching MemoCache::LIMIT
+};
+
+/**
+ * @brief Result cache of one `memo sub`.
+ * * @details Results are keyed by the argument list (Value::hash / operator==),
+ * so calls with arguments that can't be map keys simply run. The cache is
+ * bounded: once it holds LIMIT results it is emptied and starts over, which
+ * keeps the recent working set without tracking per-entry age.
+ * * Caching is only sound for pure functions, see FrameLayout for the per-body
+ * check and verify() for the one across the subs it calls.
+ */
+class MemoCache {
+public:
+    static constexpr size_t LIMIT = 4096;
+
+    /// Whether a call with these arguments can be cached at all.
+    static bool cacheable(const std::vector<Value>& args);
+
+    /// The stored result, nullptr on a miss.
+    const Value* find(const std::vector<Value>& args);
+    void store(std::vector<Value> args, const Value& result);
+
+    /// find() and store() for the threads of a parallel loop, which share every cache under one lock.
+    bool findShared(const std::vector<Value>& args, Value& result);
+    void storeShared(std::vector<Value> args, const Value& result);
+
+    /**
+     * @brief Checks that func and every sub it (transitively) calls is pure.
+     * @details Callees are looked up by name in global the first time the memo
+     * sub runs; the outcome is remembered in FunctionData::verified along with
+     * the subs the names resolved to. Later calls only check those names still
+     * resolve to the same subs. When one was redefined, the cached results may
+     * come from the old one: the cache is emptied and the check runs again.
+     * @throw std::runtime_error Naming the first impure function found.
+     */
+    static void verify(SymbolContainer& env, FunctionData& func, uint32_t nameId, int line);
+
+    static constexpr uint32_t ALL_PURE = UINT32_MAX;
+
+    /**
+     * @brief The walk behind verify(), from a list of (sub, name) roots.
+     * @details With framed set, subs that run in a call scope instead of a
+     * frame (FunctionData::frameSize) are rejected as well. reached, when
+     * given, gets every callee name looked up and what it resolved to.
+     * @return Name of the first sub that fails, ALL_PURE if none does.
+     */
+    static uint32_t findImpure(SymbolContainer& env, std::vector<std::pair<const FunctionData*, uint32_t>> pending,
+                               bool framed = false, CalleeBindings* reached = nullptr);
+
+    static MemoStats stats() { return counters; }
+
+private:
+    struct ArgsHash {
+        size_t operator()(const std::vector<Value>& args) const;
+    };
+
+    std::unordered_map<std::vector<Value>, Value, ArgsHash> results;
+
+    static MemoStats counters;
+    static std::mutex sharing;
+};
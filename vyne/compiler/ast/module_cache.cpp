@@ -0,0 +1,133 @@
+#include "module_cache.h"
+#include "../parser/parser.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+ModuleCache::Source ModuleCache::locate(const std::string& path) {
+    namespace fs = std::filesystem;
+
+    Source source;
+    std::error_code ec;
+    fs::path canonical = fs::canonical(path, ec);
+    if (ec) return source;
+
+    source.key = canonical.string();
+    source.modified = fs::last_write_time(canonical, ec);
+    source.size = fs::file_size(canonical, ec);
+    return source;
+}
+
+const ModuleCache::Module& ModuleCache::load(const std::string& path) {
+    Source source = locate(path);
+    if (source.key.empty()) FileUtils::readFile(path);   // throws the usual IO error
+
+    const std::string& key = source.key;
+
+    auto it = modules.find(key);
+    if (it != modules.end() && it->second->modified == source.modified && it->second->size == source.size) {
+        return *it->second;
+    }
+
+    if (!loading.insert(key).second) {
+        throw std::runtime_error("Runtime Error: '" + path + "' is used again while it is still loading");
+    }
+
+    // unmarked however we leave, a failed load can be retried
+    struct Unmark {
+        std::unordered_set<std::string>& loading;
+        const std::string& key;
+        ~Unmark() { loading.erase(key); }
+    } unmark{loading, key};
+
+    auto module = std::make_unique<Module>();
+    module->modified = source.modified;
+    module->size = source.size;
+
+    auto pre = preparsed.find(key);
+    if (pre != preparsed.end()) {
+        if (pre->second.modified == source.modified && pre->second.size == source.size) {
+            module->program = std::move(pre->second.program);
+        }
+        preparsed.erase(pre);
+    }
+
+    try {
+        if (!module->program) {
+            const std::string text = FileUtils::readFile(key);
+            module->program = Parser(text).parseProgram();
+        }
+        module->program->evaluate(module->exports, SymbolContainer::GLOBAL);
+    } catch (const std::runtime_error& e) {
+        throw std::runtime_error("In " + path + ": " + e.what());
+    }
+
+    // functions bound from an older version keep that AST alive through FunctionData::owner
+    auto& slot = modules[key];
+    slot = std::move(module);
+    return *slot;
+}
+
+void ModuleCache::preload(const std::vector<std::string>& paths) {
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<std::string> queue(paths.begin(), paths.end());
+    std::unordered_set<std::string> seen(paths.begin(), paths.end());   // as written in `use`
+    std::unordered_set<std::string> claimed;                             // canonical, one parse per file
+    size_t busy = 0;
+
+    auto work = [&] {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        while (true) {
+            changed.wait(lock, [&] { return !queue.empty() || busy == 0; });
+            if (queue.empty()) return;   // nothing queued and nobody left to queue more
+
+            std::string path = std::move(queue.front());
+            queue.pop_front();
+            busy++;
+            lock.unlock();
+
+            Source source = locate(path);
+            Parsed parsed;
+            std::vector<std::string> found;
+
+            lock.lock();
+            bool fresh = !source.key.empty() && !modules.count(source.key) && claimed.insert(source.key).second;
+            lock.unlock();
+
+            if (fresh) {
+                try {
+                    const std::string text = FileUtils::readFile(source.key);
+                    Parser parser(text);
+                    parsed.program = parser.parseProgram();
+                    parsed.modified = source.modified;
+                    parsed.size = source.size;
+                    found = parser.imports();
+                } catch (const std::exception&) {
+                    parsed.program.reset();   // load() parses it again and reports the error
+                }
+            }
+
+            lock.lock();
+            if (parsed.program) {
+                preparsed[source.key] = std::move(parsed);
+            }
+            for (std::string& next : found) {
+                if (seen.insert(next).second) queue.push_back(std::move(next));
+            }
+            busy--;
+            changed.notify_all();
+        }
+    };
+
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> helpers;
+    for (size_t i = 1; i < threads; ++i) helpers.emplace_back(work);
+
+    work();
+    for (std::thread& helper : helpers) helper.join();
+}
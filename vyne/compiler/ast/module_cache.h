@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "ast.h"
+
+/**
+ * @brief Process-wide cache of the files pulled in with `use`.
+ * * @details A file is read, parsed and evaluated once, into a SymbolContainer
+ * of its own; every later `use` of it binds to those exports. Entries are keyed
+ * by canonical path and checked against the file's modification time and size
+ * on each load, so an edited file is loaded again.
+ * * preload() can parse a program's whole import graph up front, on several
+ * threads. Evaluation still only happens in load(), when the `use` runs, so
+ * the program's behaviour doesn't depend on which file finished parsing first.
+ */
+class ModuleCache {
+public:
+    struct Module {
+        std::shared_ptr<ProgramNode> program;   // keeps the file's AST alive
+        SymbolContainer exports;
+        std::filesystem::file_time_type modified;
+        uintmax_t size = 0;
+    };
+
+    static ModuleCache& instance() {
+        static ModuleCache cache;
+        return cache;
+    }
+
+    /**
+     * @brief The evaluated file at path, loaded on first use or when it changed.
+     * @throw std::runtime_error If the file can't be read, doesn't parse, fails
+     * while evaluating (nothing is cached then), or is already being loaded
+     * further up (a `use` cycle).
+     */
+    const Module& load(const std::string& path);
+
+    /**
+     * @brief Parses paths and every file they `use`, transitively, in parallel.
+     * @details Runs on std::thread::hardware_concurrency() threads and returns
+     * once the graph is parsed. Files that fail to read or parse are skipped
+     * here; load() reports them when their `use` runs.
+     */
+    void preload(const std::vector<std::string>& paths);
+
+private:
+    struct Source {
+        std::string key;   // canonical path, empty if the file doesn't exist
+        std::filesystem::file_time_type modified;
+        uintmax_t size = 0;
+    };
+
+    struct Parsed {
+        std::shared_ptr<ProgramNode> program;
+        std::filesystem::file_time_type modified;
+        uintmax_t size = 0;
+    };
+
+    static Source locate(const std::string& path);
+
+    std::unordered_map<std::string, std::unique_ptr<Module>> modules;
+    std::unordered_map<std::string, Parsed> preparsed;   // filled by preload(), taken by load()
+    std::unordered_set<std::string> loading;
+};
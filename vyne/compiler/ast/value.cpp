@@ -1,5 +1,11 @@
 #include "value.h"
 
+#include <cstring>
+
+Value::Value(std::string s) : data(std::make_shared<StringData>(std::move(s))) {}
+
+Value::Value(std::vector<Value> l) : data(std::make_shared<ArrayData>(std::move(l))) {}
+
 int Value::getType() const { return static_cast<int>(data.index()); }
 
 std::string Value::getTypeName() const { 
@@ -10,6 +16,8 @@ std::string Value::getTypeName() const {
         case Value::ARRAY:    return "Array";
         case Value::FUNCTION: return "Function";
         case Value::MODULE:   return "Module";
+        case Value::MAP:      return "Map";
+        case Value::MATRIX:   return "Matrix";
         default:              return "Unknown";
     }
 }
@@ -19,15 +27,35 @@ double Value::asNumber() const {
 }
 
 const std::string& Value::asString() const { 
-    return *std::get<std::shared_ptr<std::string>>(this->data); 
+    return std::get<std::shared_ptr<StringData>>(this->data)->str(); 
+}
+
+const std::shared_ptr<StringData>& Value::asStringData() const {
+    return std::get<std::shared_ptr<StringData>>(this->data);
+}
+
+const ArrayData& Value::asArray() const { 
+    return *std::get<std::shared_ptr<ArrayData>>(this->data); 
+}
+
+ArrayData& Value::editArray() {
+    auto& arr = std::get<std::shared_ptr<ArrayData>>(this->data);
+    if (arr.use_count() > 1) arr = std::make_shared<ArrayData>(*arr);
+    return *arr;
+}
+
+const MapData& Value::asMap() const {
+    return *std::get<std::shared_ptr<MapData>>(this->data);
 }
 
-std::vector<Value>& Value::asList() { 
-    return *std::get<std::shared_ptr<std::vector<Value>>>(this->data); 
+MapData& Value::editMap() {
+    auto& map = std::get<std::shared_ptr<MapData>>(this->data);
+    if (map.use_count() > 1) map = std::make_shared<MapData>(*map);
+    return *map;
 }
 
-const std::vector<Value>& Value::asList() const { 
-    return *std::get<std::shared_ptr<std::vector<Value>>>(this->data); 
+const MatrixData& Value::asMatrix() const {
+    return *std::get<std::shared_ptr<MatrixData>>(this->data);
 }
 
 const std::shared_ptr<FunctionData>& Value::asFunction() const { 
@@ -52,15 +80,24 @@ void Value::print(std::ostream& os) const {
             os << std::get<double>(data);
             break;
         case 2 :
-            os << "\"" << *std::get<std::shared_ptr<std::string>>(data) << "\"";
+            os << "\"" << asString() << "\"";
             break;
         case 3 : {
-            const auto& list = *std::get<std::shared_ptr<std::vector<Value>>>(data);
+            const auto& arr = *std::get<std::shared_ptr<ArrayData>>(data);
 
             os << "[";
-            for (size_t i = 0; i < list.size(); ++i) {
-                list[i].print(os);
-                if (i < list.size() - 1) os << ", ";
+            if (arr.isPacked()) {
+                const auto& nums = arr.packedData();
+                for (size_t i = 0; i < nums.size(); ++i) {
+                    os << nums[i];
+                    if (i < nums.size() - 1) os << ", ";
+                }
+            } else {
+                const auto& list = arr.genericData();
+                for (size_t i = 0; i < list.size(); ++i) {
+                    list[i].print(os);
+                    if (i < list.size() - 1) os << ", ";
+                }
             }
             os << "]";
             break;
@@ -72,6 +109,37 @@ void Value::print(std::ostream& os) const {
         case 5:
             os << "<module '" << std::get<ModuleData>(data).name << "'>";
             break;
+        case 6: {
+            bool first = true;
+
+            os << "{";
+            for (const auto& entry : asMap().rawEntries()) {
+                if (!entry.live) continue;
+                if (!first) os << ", ";
+                entry.key.print(os);
+                os << ": ";
+                entry.value.print(os);
+                first = false;
+            }
+            os << "}";
+            break;
+        }
+        case 7: {
+            const auto& matrix = asMatrix();
+
+            os << "matrix([";
+            for (size_t r = 0; r < matrix.rows(); ++r) {
+                if (r > 0) os << ", ";
+                os << "[";
+                for (size_t c = 0; c < matrix.cols(); ++c) {
+                    if (c > 0) os << ", ";
+                    os << matrix.at(r, c);
+                }
+                os << "]";
+            }
+            os << "])";
+            break;
+        }
         default:
             os << "<unknown>";
             break; 
@@ -82,13 +150,17 @@ size_t Value::getDeepBytes() const {
     switch(data.index()){
         case 1: return sizeof(double);
         case 2: {
-            auto& s = *std::get<std::shared_ptr<std::string>>(data);
-            return sizeof(std::string) + s.capacity();
+            auto& s = *std::get<std::shared_ptr<StringData>>(data);
+            return sizeof(StringData) + s.size();
         }
         case 3: {
-            auto& v = *std::get<std::shared_ptr<std::vector<Value>>>(data);
-            size_t total = sizeof(std::vector<Value>) + (v.capacity() * sizeof(Value));
-            for (const auto& item : v) total += item.getDeepBytes();
+            auto& arr = *std::get<std::shared_ptr<ArrayData>>(data);
+            if (arr.isPacked()) {
+                return sizeof(ArrayData) + (arr.capacity() * sizeof(double));
+            }
+
+            size_t total = sizeof(ArrayData) + (arr.capacity() * sizeof(Value));
+            for (const auto& item : arr.genericData()) total += item.getDeepBytes();
             return total;
         }
         
@@ -99,9 +171,20 @@ size_t Value::getDeepBytes() const {
             size_t total = sizeof(FunctionData);
 
             total += func->params.capacity() * sizeof(uint32_t);
-            total += func->body.capacity() * sizeof(std::shared_ptr<ASTNode>);
+            total += func->body.size() * sizeof(ASTNode*);
+            return total;
+        }
+        case 6: {
+            const auto& map = asMap();
+            size_t total = sizeof(MapData) + map.capacity() * (sizeof(int8_t) + sizeof(uint32_t));
+
+            total += map.rawEntries().capacity() * sizeof(MapData::Entry);
+            for (const auto& entry : map.rawEntries()) {
+                if (entry.live) total += entry.key.getDeepBytes() + entry.value.getDeepBytes();
+            }
             return total;
         }
+        case 7: return sizeof(MatrixData) + asMatrix().values().capacity() * sizeof(double);
         default: return 0;
     }
 }
@@ -111,17 +194,27 @@ size_t Value::getShallowBytes() const {
         case 1:
             return sizeof(double);
         case 2: 
-            return std::get<std::shared_ptr<std::string>>(data)->length() * sizeof(char);
+            return std::get<std::shared_ptr<StringData>>(data)->size() * sizeof(char);
         case 3: {
-            size_t total = 0;
+            const auto& arr = *std::get<std::shared_ptr<ArrayData>>(data);
+            if (arr.isPacked()) return arr.size() * sizeof(double);
 
-            const auto& list = *std::get<std::shared_ptr<std::vector<Value>>>(data);
-            for (const auto& v : list) {
+            size_t total = 0;
+            for (const auto& v : arr.genericData()) {
                 total += v.getShallowBytes();
             }
 
             return total;
         }
+        case 6: {
+            size_t total = 0;
+            for (const auto& entry : asMap().rawEntries()) {
+                if (entry.live) total += entry.key.getShallowBytes() + entry.value.getShallowBytes();
+            }
+            return total;
+        }
+        case 7:
+            return asMatrix().size() * sizeof(double);
 
         default :
             return 0;
@@ -134,7 +227,7 @@ bool Value::equals(const Value& other) const {
     switch(getType()) {
         case 0: return true;
         case 1: return asNumber() == other.asNumber();
-        case 2: return asString() == other.asString();
+        case 2: return asStringData()->size() == other.asStringData()->size() && asString() == other.asString();
         default: return false;
     }
 }
@@ -148,7 +241,7 @@ std::string Value::toString() const {
             return s;
         }
         case 2:
-            return *std::get<std::shared_ptr<std::string>>(data);
+            return asString();
         case 0: 
             return "null";
         default: {
@@ -165,7 +258,7 @@ int Value::toNumber() const {
         case 1 :  return std::get<double>(data);
         case 2 : {
             try {
-            return std::stod(*std::get<std::shared_ptr<std::string>>(data));
+            return std::stod(asString());
         } catch (...) {
             return 0.0; 
         }
@@ -178,8 +271,10 @@ int Value::toNumber() const {
 bool Value::isTruthy() const {
     switch(getType()) {
         case Value::NUMBER:  return asNumber() != 0;
-        case Value::STRING:  return !asString().empty();
-        case Value::ARRAY:   return !asList().empty();
+        case Value::STRING:  return asStringData()->size() != 0;
+        case Value::ARRAY:   return !asArray().empty();
+        case Value::MAP:     return !asMap().empty();
+        case Value::MATRIX:  return asMatrix().size() != 0;
         default:             return false;
     }
 }
@@ -191,8 +286,10 @@ bool Value::operator==(const Value& other) const {
     switch (this->data.index()) {
         case 0: return true;
         case 1: return std::get<double>(this->data) == std::get<double>(other.data);
-        case 2: return *std::get<std::shared_ptr<std::string>>(this->data) == *std::get<std::shared_ptr<std::string>>(other.data);
-        case 3: return *std::get<std::shared_ptr<std::vector<Value>>>(this->data) == *std::get<std::shared_ptr<std::vector<Value>>>(other.data);
+        case 2: return asStringData()->size() == other.asStringData()->size() && asString() == other.asString();
+        case 3: return *std::get<std::shared_ptr<ArrayData>>(this->data) == *std::get<std::shared_ptr<ArrayData>>(other.data);
+        case 6: return asMap() == other.asMap();
+        case 7: return asMatrix() == other.asMatrix();
         default: return false; 
     }
 }
@@ -203,8 +300,10 @@ bool Value::operator!=(const Value& other) const {
     switch (this->data.index()) {
         case 0: return false;
         case 1: return std::get<double>(this->data) != std::get<double>(other.data);
-        case 2: return *std::get<std::shared_ptr<std::string>>(this->data) != *std::get<std::shared_ptr<std::string>>(other.data);
-        case 3: return *std::get<std::shared_ptr<std::vector<Value>>>(this->data) != *std::get<std::shared_ptr<std::vector<Value>>>(other.data);
+        case 2: return asStringData()->size() != other.asStringData()->size() || asString() != other.asString();
+        case 3: return !(*std::get<std::shared_ptr<ArrayData>>(this->data) == *std::get<std::shared_ptr<ArrayData>>(other.data));
+        case 6: return !(asMap() == other.asMap());
+        case 7: return !(asMatrix() == other.asMatrix());
         default: return true; 
     }
 }
@@ -218,21 +317,429 @@ bool Value::operator<(const Value& other) const {
         case 1:
             return std::get<double>(data) < std::get<double>(other.data);
         case 2:
-            return *std::get<std::shared_ptr<std::string>>(data) < *std::get<std::shared_ptr<std::string>>(other.data);
+            return asString() < other.asString();
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Finalizer from splitmix64, spreads entropy into every bit.
+ * * @details Whole numbers stored as doubles have all-zero low mantissa bits,
+ * and the map uses the low bits for its control tags, so raw bit patterns
+ * must be mixed before use.
+ */
+
+static size_t mixHash(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return static_cast<size_t>(x);
+}
+
+bool Value::isHashable() const {
+    switch (data.index()) {
+        case 0:
+        case 1:
+        case 2:
+            return true;
+        case 3: {
+            const auto& arr = asArray();
+            if (arr.isPacked()) return true;
+            for (const auto& item : arr.genericData()) {
+                if (!item.isHashable()) return false;
+            }
+            return true;
+        }
         default:
             return false;
     }
 }
 
-uint32_t StringPool::intern(const std::string& s) {
+/**
+ * @brief Hashes a value so that equal values (operator==) hash equally.
+ * * @details Numbers hash by bit pattern (with -0 folded into 0), strings use
+ * the hash cached on their StringData, arrays combine their elements.
+ * @throw std::runtime_error For values that cannot be map keys, see isHashable().
+ */
+
+size_t Value::hash() const {
+    switch (data.index()) {
+        case 0:
+            return mixHash(0x9e3779b97f4a7c15ULL);
+        case 1: {
+            double d = std::get<double>(data);
+            if (d == 0) d = 0.0;
+
+            uint64_t bits;
+            std::memcpy(&bits, &d, sizeof(bits));
+            return mixHash(bits);
+        }
+        case 2:
+            return asStringData()->hash();
+        case 3: {
+            const auto& arr = asArray();
+            uint64_t h = arr.size();
+            for (size_t i = 0; i < arr.size(); ++i) {
+                h = mixHash(h ^ arr.at(i).hash());
+            }
+            return static_cast<size_t>(h);
+        }
+        default:
+            throw std::runtime_error("Type Error: " + getTypeName() + " cannot be used as a map key");
+    }
+}
+
+/**
+ * @brief Concatenates two strings without copying either side.
+ * * @details Short results are still copied into a flat buffer, a rope node
+ * would cost more than the copy. Longer ones become a rope node that is
+ * flattened lazily by StringData::str().
+ */
+
+Value Value::concat(const Value& l, const Value& r) {
+    const auto& ls = l.asStringData();
+    const auto& rs = r.asStringData();
+
+    if (rs->size() == 0) return l;
+    if (ls->size() == 0) return r;
+
+    constexpr size_t FLAT_LIMIT = 64;
+    if (ls->size() + rs->size() <= FLAT_LIMIT) {
+        std::string joined;
+        joined.reserve(ls->size() + rs->size());
+        joined += ls->str();
+        joined += rs->str();
+        return Value(std::move(joined));
+    }
+
+    return Value(std::make_shared<StringData>(ls, rs));
+}
+
+StringData::~StringData() {
+    // Long ropes are deep (s = s + x in a loop builds a left spine), so
+    // release uniquely owned children iteratively instead of recursing.
+    std::vector<std::shared_ptr<StringData>> pending;
+    if (left) pending.emplace_back(std::move(left));
+    if (right) pending.emplace_back(std::move(right));
+
+    while (!pending.empty()) {
+        std::shared_ptr<StringData> node = std::move(pending.back());
+        pending.pop_back();
+
+        if (node.use_count() == 1) {
+            if (node->left) pending.emplace_back(std::move(node->left));
+            if (node->right) pending.emplace_back(std::move(node->right));
+        }
+    }
+}
+
+const std::string& StringData::flatten() const {
+    static std::mutex flattening;
+    std::lock_guard<std::mutex> lock(flattening);
+    if (isFlat()) return flat;
+
+    std::string joined;
+    joined.reserve(length);
+
+    std::vector<const StringData*> stack { this };
+    while (!stack.empty()) {
+        const StringData* node = stack.back();
+        stack.pop_back();
+
+        if (node->isFlat()) {
+            joined += node->flat;
+            continue;
+        }
+        stack.emplace_back(node->right.get());
+        stack.emplace_back(node->left.get());
+    }
+
+    flat = std::move(joined);
+    left.reset();
+    right.reset();
+    flattened.store(true, std::memory_order_release);
+    return flat;
+}
+
+size_t StringData::hash() const {
+    if (!hashed.load(std::memory_order_acquire)) {
+        hashCache.store(mixHash(std::hash<std::string>{}(str())), std::memory_order_relaxed);
+        hashed.store(true, std::memory_order_release);
+    }
+    return hashCache.load(std::memory_order_relaxed);
+}
+
+ArrayData::ArrayData(std::vector<Value> items) {
+    for (const auto& item : items) {
+        if (item.getType() != Value::NUMBER) {
+            values = std::move(items);
+            packed = false;
+            return;
+        }
+    }
+
+    numbers.reserve(items.size());
+    for (const auto& item : items) numbers.emplace_back(item.asNumber());
+}
+
+Value ArrayData::at(size_t index) const {
+    if (packed) return Value(numbers.at(index));
+    return values.at(index);
+}
+
+void ArrayData::set(size_t index, const Value& val) {
+    if (index >= size()) throw std::out_of_range("ArrayData::set");
+
+    if (packed) {
+        if (val.getType() == Value::NUMBER) {
+            numbers[index] = val.asNumber();
+            return;
+        }
+        spill();
+    }
+    values[index] = val;
+}
+
+void ArrayData::push(const Value& val) {
+    if (packed) {
+        if (val.getType() == Value::NUMBER) {
+            numbers.emplace_back(val.asNumber());
+            return;
+        }
+        spill();
+    }
+    values.emplace_back(val);
+}
+
+void ArrayData::pop() {
+    if (packed) numbers.pop_back();
+    else values.pop_back();
+}
+
+void ArrayData::clear() {
+    numbers.clear();
+    values.clear();
+    packed = true;
+}
+
+void ArrayData::reserve(size_t count) {
+    if (packed) numbers.reserve(count);
+    else values.reserve(count);
+}
+
+void ArrayData::append(const ArrayData& other) {
+    if (packed && other.packed) {
+        numbers.insert(numbers.end(), other.numbers.begin(), other.numbers.end());
+        return;
+    }
+
+    spill();
+    values.reserve(values.size() + other.size());
+    if (other.packed) {
+        for (double n : other.numbers) values.emplace_back(n);
+    } else {
+        values.insert(values.end(), other.values.begin(), other.values.end());
+    }
+}
+
+bool ArrayData::erase(const Value& val) {
+    if (packed) {
+        if (val.getType() != Value::NUMBER) return false;
+
+        auto it = std::find(numbers.begin(), numbers.end(), val.asNumber());
+        if (it == numbers.end()) return false;
+        numbers.erase(it);
+        return true;
+    }
+
+    auto it = std::find(values.begin(), values.end(), val);
+    if (it == values.end()) return false;
+    values.erase(it);
+    return true;
+}
+
+void ArrayData::spill() {
+    if (!packed) return;
+
+    values.reserve(numbers.size());
+    for (double n : numbers) values.emplace_back(n);
+
+    numbers.clear();
+    numbers.shrink_to_fit();
+    packed = false;
+}
+
+bool ArrayData::tryPack() {
+    if (packed) return true;
+
+    for (const auto& v : values) {
+        if (v.getType() != Value::NUMBER) return false;
+    }
+
+    numbers.reserve(values.size());
+    for (const auto& v : values) numbers.emplace_back(v.asNumber());
+
+    values.clear();
+    values.shrink_to_fit();
+    packed = true;
+    return true;
+}
+
+bool ArrayData::operator==(const ArrayData& other) const {
+    if (size() != other.size()) return false;
+    if (packed && other.packed) return numbers == other.numbers;
+    if (!packed && !other.packed) return values == other.values;
+
+    for (size_t i = 0; i < size(); ++i) {
+        if (at(i) != other.at(i)) return false;
+    }
+    return true;
+}
+
+size_t MapData::findSlot(const Value& key, size_t hash) const {
+    if (ctrl.empty()) return SIZE_MAX;
+
+    const size_t mask = ctrl.size() - 1;
+    const int8_t tag = tagOf(hash);
+
+    // the load factor stays below 7/8, so the probe always reaches an EMPTY slot
+    for (size_t i = (hash >> 7) & mask;; i = (i + 1) & mask) {
+        int8_t c = ctrl[i];
+        if (c == EMPTY) return SIZE_MAX;
+        if (c == tag) {
+            const Entry& entry = entries[slots[i]];
+            if (entry.hash == hash && entry.key == key) return i;
+        }
+    }
+}
+
+void MapData::rehash(size_t minCapacity) {
+    size_t cap = 8;
+    while (cap * 7 / 8 < minCapacity) cap *= 2;
+
+    if (liveCount != entries.size()) {
+        entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                     [](const Entry& e) { return !e.live; }),
+                      entries.end());
+    }
+
+    ctrl.assign(cap, EMPTY);
+    slots.assign(cap, 0);
+
+    const size_t mask = cap - 1;
+    for (size_t idx = 0; idx < entries.size(); ++idx) {
+        size_t i = (entries[idx].hash >> 7) & mask;
+        while (ctrl[i] != EMPTY) i = (i + 1) & mask;
+
+        ctrl[i] = tagOf(entries[idx].hash);
+        slots[i] = static_cast<uint32_t>(idx);
+    }
+    usedSlots = liveCount;
+}
+
+const Value* MapData::find(const Value& key) const {
+    size_t slot = findSlot(key, key.hash());
+    return slot == SIZE_MAX ? nullptr : &entries[slots[slot]].value;
+}
+
+Value* MapData::find(const Value& key) {
+    size_t slot = findSlot(key, key.hash());
+    return slot == SIZE_MAX ? nullptr : &entries[slots[slot]].value;
+}
+
+void MapData::set(const Value& key, const Value& val) {
+    const size_t hash = key.hash();
+
+    size_t slot = findSlot(key, hash);
+    if (slot != SIZE_MAX) {
+        entries[slots[slot]].value = val;
+        return;
+    }
+
+    if ((usedSlots + 1) * 8 > ctrl.size() * 7) rehash((liveCount + 1) * 2);
+
+    const size_t mask = ctrl.size() - 1;
+    size_t i = (hash >> 7) & mask;
+    while (ctrl[i] != EMPTY && ctrl[i] != DELETED) i = (i + 1) & mask;
+
+    if (ctrl[i] == EMPTY) usedSlots++;
+    ctrl[i] = tagOf(hash);
+    slots[i] = static_cast<uint32_t>(entries.size());
+
+    Value storedKey = key;
+    storedKey.isReadOnly = false;
+    entries.push_back(Entry{std::move(storedKey), val, hash, true});
+    liveCount++;
+}
+
+bool MapData::remove(const Value& key) {
+    size_t slot = findSlot(key, key.hash());
+    if (slot == SIZE_MAX) return false;
+
+    Entry& entry = entries[slots[slot]];
+    entry.key = Value();
+    entry.value = Value();
+    entry.live = false;
+
+    ctrl[slot] = DELETED;
+    liveCount--;
+
+    // keep tombstones from dominating the entry list
+    if (entries.size() > 8 && liveCount < entries.size() / 2) rehash(liveCount * 2);
+    return true;
+}
+
+void MapData::reserve(size_t count) {
+    if (count * 8 > ctrl.size() * 7) rehash(count);
+    entries.reserve(count);
+}
+
+std::vector<Value> MapData::keys() const {
+    std::vector<Value> result;
+    result.reserve(liveCount);
+    for (const auto& entry : entries) {
+        if (entry.live) result.emplace_back(entry.key);
+    }
+    return result;
+}
+
+bool MapData::operator==(const MapData& other) const {
+    if (liveCount != other.liveCount) return false;
+
+    for (const auto& entry : entries) {
+        if (!entry.live) continue;
+
+        const Value* theirs = other.find(entry.key);
+        if (!theirs || *theirs != entry.value) return false;
+    }
+    return true;
+}
+
+uint32_t StringPool::intern(std::string_view s) {
     StringPool& pool = StringPool::instance();
 
+    {
+        std::shared_lock<std::shared_mutex> read(pool.mutex);
+        auto it = pool.strToId.find(s);
+        if (it != pool.strToId.end()) return it->second;
+    }
+
+    std::unique_lock<std::shared_mutex> write(pool.mutex);
+    // another thread may have added it between the two locks
     auto it = pool.strToId.find(s);
     if (it != pool.strToId.end()) return it->second;
 
-    uint32_t newId = static_cast<uint32_t>(pool.idToStr.size());
-    pool.idToStr.emplace_back(s);
-    pool.strToId[s] = newId;
+    uint32_t newId = pool.count;
+    auto& chunk = pool.chunks.at(newId / CHUNK_SIZE);
+    if (!chunk) chunk = std::make_unique<std::string[]>(CHUNK_SIZE);
+
+    std::string& stored = chunk[newId % CHUNK_SIZE];
+    stored = s;
+    pool.strToId.emplace(stored, newId);
+    pool.count++;
 
     return newId;
 }
\ No newline at end of file
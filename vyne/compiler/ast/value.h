@@ -1,8 +1,14 @@
 #pragma once
 #include <iostream>
 #include <string>
+#include <string_view>
+#include <array>
+#include <atomic>
+#include <shared_mutex>
+#include <mutex>
 #include <memory>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 #include <algorithm>
 #include <stdexcept>
@@ -11,31 +17,62 @@
 #include <functional>
 #include <cstdint>
 
+#include "arena.h"
+
 class ASTNode;
 struct Value;
 struct FunctionData;
 struct ModuleData;
+class ArrayData;
+class StringData;
+class MapData;
+class MatrixData;
+class MemoCache;
+struct NativeContext;
+
+/**
+ * @brief Entry point of a native function.
+ * @details args points at argc evaluated arguments owned by the caller (a
+ * buffer on its stack), so a call allocates nothing. See NativeContext.
+ */
+using NativeFn = Value (*)(const Value* args, size_t argc, NativeContext& ctx);
 
 struct ModuleData { 
     uint32_t moduleId;
     std::string name; 
 };
 
+/// What each name a sub calls resolved to in global, see MemoCache::verify.
+using CalleeBindings = std::vector<std::pair<uint32_t, std::weak_ptr<FunctionData>>>;
+
 struct FunctionData {
     std::vector<uint32_t> params;
-    std::vector<std::shared_ptr<ASTNode>> body; 
+    ArenaList<ASTNode*> body;
+    std::shared_ptr<AstArena> owner; // keeps the body's nodes alive
+    uint32_t frameSize = UINT32_MAX; // locals per call, UINT32_MAX: runs in a call scope (see FrameLayout)
+
+    bool memo = false;                  // `memo sub`, results are kept in memoCache
+    bool pure = false;                  // the body alone is pure, see FrameLayout
+    bool verified = false;              // pure including its callees, see MemoCache::verify
+    std::vector<uint32_t> callees;      // names of the subs the body calls
+    CalleeBindings boundCallees;        // the subs those names (transitively) were when verified
+    std::shared_ptr<MemoCache> memoCache;
 
-    std::function<Value(std::vector<Value>&)> nativeFn;
+    NativeFn nativeFn = nullptr;
+    std::shared_ptr<void> nativeState;  // captures of a native registered as a lambda, see makeNative
     bool isNative = false;
+    int arity = -1;                     // natives: argument count checked by the caller, -1 if the function checks it
 };
 
 using ValueData = std::variant<
         std::monostate,
         double,
-        std::shared_ptr<std::string>,
-        std::shared_ptr<std::vector<Value>>,
+        std::shared_ptr<StringData>,
+        std::shared_ptr<ArrayData>,
         std::shared_ptr<FunctionData>,
-        ModuleData
+        ModuleData,
+        std::shared_ptr<MapData>,
+        std::shared_ptr<MatrixData>
 >;
 
 struct Value {
@@ -45,7 +82,9 @@ struct Value {
         STRING = 2, 
         ARRAY = 3, 
         FUNCTION = 4, 
-        MODULE = 5 
+        MODULE = 5,
+        MAP = 6,
+        MATRIX = 7
     };
 
     ValueData data;
@@ -54,23 +93,18 @@ struct Value {
     // constructors
     Value() : data(std::monostate{}) {}
     Value(double n) : data(n) {}
-    Value(std::string s) 
-    : data(std::make_shared<std::string>(std::move(s))) {}
-    Value(std::vector<Value> l) 
-    : data(std::make_shared<std::vector<Value>>(std::move(l))) {}
+    Value(std::string s);
+    Value(std::shared_ptr<StringData> s) : data(std::move(s)) {}
+    Value(std::vector<Value> l);
+    Value(std::shared_ptr<ArrayData> a) : data(std::move(a)) {}
     Value(std::shared_ptr<FunctionData> f) : data(std::move(f)) {}
-    Value(std::vector<uint32_t> p, std::vector<std::shared_ptr<ASTNode>> b) {
-        auto func = std::make_shared<FunctionData>();
-        func->params = std::move(p);
-        func->body = std::move(b);
-        
-        data = std::move(func); 
-    }
+    Value(std::shared_ptr<MapData> m) : data(std::move(m)) {}
+    Value(std::shared_ptr<MatrixData> m) : data(std::move(m)) {}
     Value(uint32_t mId, std::string moduleName, bool isModule) 
         : data(ModuleData{mId, std::move(moduleName)}) {}
-    Value(std::function<Value(std::vector<Value>&)> native) {
+    Value(NativeFn native) {
         auto func = std::make_shared<FunctionData>();
-        func->nativeFn = std::move(native);
+        func->nativeFn = native;
         func->isNative = true;
         data = std::move(func);
     }
@@ -83,10 +117,19 @@ struct Value {
     double asNumber() const;
 
     const std::string& asString() const;
+    const std::shared_ptr<StringData>& asStringData() const;
+
+    const ArrayData& asArray() const;
 
-    std::vector<Value>& asList();
+    // copy-on-write access, clones the storage first if other values share it
+    ArrayData& editArray();
 
-    const std::vector<Value>& asList() const;
+    const MapData& asMap() const;
+
+    // copy-on-write access, same rules as editArray()
+    MapData& editMap();
+
+    const MatrixData& asMatrix() const;
 
     const std::shared_ptr<FunctionData>& asFunction() const;
 
@@ -101,17 +144,208 @@ struct Value {
     bool equals(const Value& other) const;
     std::string toString()          const;
     int toNumber()                  const;
+    bool isHashable()               const;
+    size_t hash()                   const;
 
     bool operator==(const Value& other) const;
     bool operator!=(const Value& other) const;
     bool operator<(const Value& other) const;
+
+    static Value concat(const Value& l, const Value& r);
+};
+
+/**
+ * @brief Backing storage for String values.
+ * * @details Concatenation doesn't copy either side: it produces a rope node
+ * that only remembers its two halves and the total length. The text is
+ * flattened into a single buffer the first time it is actually read
+ * (print, compare, hash, ...) and the halves are released at that point,
+ * so building a string piece by piece in a loop stays linear.
+ * * Strings are shared by the threads of a `parallel` loop: flattening takes
+ * a lock (once per rope), the flags that publish its result are atomic.
+ */
+class StringData {
+    mutable std::string flat;
+    mutable std::shared_ptr<StringData> left;
+    mutable std::shared_ptr<StringData> right;
+    size_t length;
+    mutable std::atomic<size_t> hashCache{0};
+    mutable std::atomic<bool> hashed{false};
+    mutable std::atomic<bool> flattened;
+
+    const std::string& flatten() const;
+
+public:
+    explicit StringData(std::string s) : flat(std::move(s)), length(flat.size()), flattened(true) {}
+    StringData(std::shared_ptr<StringData> l, std::shared_ptr<StringData> r)
+        : left(std::move(l)), right(std::move(r)), length(left->size() + right->size()), flattened(false) {}
+    StringData(const StringData&) = delete;
+    StringData& operator=(const StringData&) = delete;
+    ~StringData();
+
+    size_t size()  const { return length; }
+    bool isFlat()  const { return flattened.load(std::memory_order_acquire); }
+
+    /// The full text, flattening the rope on first access.
+    const std::string& str() const { return isFlat() ? flat : flatten(); }
+    /// Hash of the text, computed once and cached.
+    size_t hash() const;
+};
+
+/**
+ * @brief Backing storage for Array values.
+ * * @details Arrays that only ever held numbers are stored "packed" as a
+ * contiguous std::vector<double> (8 bytes per element instead of a full Value).
+ * The first non-number written into the array spills every element into
+ * generic Value storage; from then on the array behaves like a plain
+ * std::vector<Value>. Callers that only need elements should go through
+ * at()/size() and only reach for the raw vectors on hot paths.
+ * * @note Copies of a Value share the same ArrayData. Mutation must go through
+ * Value::editArray(), which clones the storage when it is not uniquely owned.
+ */
+class ArrayData {
+    std::vector<double> numbers;
+    std::vector<Value> values;
+    bool packed = true;
+
+public:
+    ArrayData() = default;
+    explicit ArrayData(std::vector<double> nums) : numbers(std::move(nums)) {}
+    explicit ArrayData(std::vector<Value> items);
+
+    bool isPacked() const { return packed; }
+    size_t size()   const { return packed ? numbers.size() : values.size(); }
+    bool empty()    const { return size() == 0; }
+    size_t capacity() const { return packed ? numbers.capacity() : values.capacity(); }
+
+    // element access (bounds checked, throws std::out_of_range)
+    Value at(size_t index) const;
+    void set(size_t index, const Value& val);
+
+    // mutation
+    void push(const Value& val);
+    void pop();
+    void clear();
+    void reserve(size_t count);
+    void append(const ArrayData& other);
+    bool erase(const Value& val);
+
+    /// Converts packed storage into generic Value storage (no-op if already generic).
+    void spill();
+    /// Re-packs generic storage when every element is a number. Returns isPacked().
+    bool tryPack();
+
+    // raw storage, only valid for the matching representation
+    std::vector<double>&       packedData()        { return numbers; }
+    const std::vector<double>& packedData()  const { return numbers; }
+    std::vector<Value>&        genericData()       { return values; }
+    const std::vector<Value>&  genericData() const { return values; }
+
+    bool operator==(const ArrayData& other) const;
+};
+
+/**
+ * @brief Backing storage for Map values.
+ * * @details Open addressing in the Swiss-table style. Every slot has a one
+ * byte control tag (empty, deleted, or the low 7 bits of the key's hash),
+ * so a probe scans a compact byte array and only compares full keys when
+ * the tag matches. Slots hold an index into a dense, insertion-ordered
+ * entry list, which keeps iteration (keys(), print) a straight walk.
+ * Removed entries are tombstoned and compacted on the next rehash.
+ * * @note Like ArrayData, copies of a Value share the same MapData; mutation
+ * must go through Value::editMap(). Keys must satisfy Value::isHashable().
+ */
+class MapData {
+public:
+    struct Entry {
+        Value key;
+        Value value;
+        size_t hash;
+        bool live;
+    };
+
+private:
+    static constexpr int8_t EMPTY   = -128;
+    static constexpr int8_t DELETED = -2;
+
+    std::vector<Entry> entries;
+    std::vector<int8_t> ctrl;
+    std::vector<uint32_t> slots;
+    size_t liveCount = 0;
+    size_t usedSlots = 0;
+
+    static int8_t tagOf(size_t hash) { return static_cast<int8_t>(hash & 0x7F); }
+
+    size_t findSlot(const Value& key, size_t hash) const;
+    void rehash(size_t minCapacity);
+
+public:
+    size_t size()     const { return liveCount; }
+    bool empty()      const { return liveCount == 0; }
+    size_t capacity() const { return ctrl.size(); }
+
+    const Value* find(const Value& key) const;
+    Value* find(const Value& key);
+    bool has(const Value& key) const { return find(key) != nullptr; }
+    void set(const Value& key, const Value& val);
+    bool remove(const Value& key);
+    void reserve(size_t count);
+
+    /// Entries in insertion order, including tombstones (skip !live).
+    const std::vector<Entry>& rawEntries() const { return entries; }
+    std::vector<Value> keys() const;
+
+    bool operator==(const MapData& other) const;
+};
+
+/**
+ * @brief Backing storage for Matrix values.
+ * * @details rows x cols numbers in one row-major buffer, so row r starts at
+ * data() + r * cols(). A matrix is never changed once built: every vmath
+ * operation returns a new one, which lets copies of a Value share it without
+ * copy-on-write.
+ */
+class MatrixData {
+    size_t rowCount;
+    size_t colCount;
+    std::vector<double> cells;
+
+public:
+    MatrixData(size_t rows, size_t cols) : rowCount(rows), colCount(cols), cells(rows * cols, 0.0) {}
+    MatrixData(size_t rows, size_t cols, std::vector<double> values)
+        : rowCount(rows), colCount(cols), cells(std::move(values)) {}
+
+    size_t rows() const { return rowCount; }
+    size_t cols() const { return colCount; }
+    size_t size() const { return cells.size(); }
+
+    double at(size_t row, size_t col) const { return cells[row * colCount + col]; }
+
+    double*       data()       { return cells.data(); }
+    const double* data() const { return cells.data(); }
+    const std::vector<double>& values() const { return cells; }
+
+    bool sameShape(const MatrixData& other) const { return rowCount == other.rowCount && colCount == other.colCount; }
+    bool operator==(const MatrixData& other) const { return sameShape(other) && cells == other.cells; }
 };
 
 // TODO ADD POOL CLEARING FEATURE WHEN THE DISMISS IS TRIGGERED
 
+/**
+ * @brief Interns names to dense ids, safe to use from several threads.
+ * @details Names live in fixed-size chunks that are never moved or freed, so
+ * strToId can key on views of them and get() needs no lock: an id can only be
+ * known after the intern() that stored its name returned. intern() takes a
+ * shared lock for names already seen and an exclusive one to add a name.
+ */
 class StringPool {
-    std::vector<std::string> idToStr;
-    std::unordered_map<std::string, uint32_t> strToId;
+    static constexpr size_t CHUNK_SIZE = 4096;
+    static constexpr size_t MAX_CHUNKS = 16384;
+
+    std::array<std::unique_ptr<std::string[]>, MAX_CHUNKS> chunks;
+    uint32_t count = 0;
+    std::unordered_map<std::string_view, uint32_t> strToId;
+    std::shared_mutex mutex;
 
 public:
     static StringPool& instance() {
@@ -119,7 +353,7 @@ public:
         return pool;
     }
     
-    static uint32_t intern(const std::string& s);
+    static uint32_t intern(std::string_view s);
 
-    const std::string& get(uint32_t id) { return idToStr[id]; }
+    const std::string& get(uint32_t id) const { return chunks[id / CHUNK_SIZE][id % CHUNK_SIZE]; }
 };
\ No newline at end of file
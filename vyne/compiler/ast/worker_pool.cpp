@@ -0,0 +1,62 @@
+#include "worker_pool.h"
+
+#include <algorithm>
+
+WorkerPool::WorkerPool() {
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t i = 1; i < threads; ++i) helpers.emplace_back(&WorkerPool::serve, this, i);
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& helper : helpers) helper.join();
+}
+
+void WorkerPool::run(size_t workers, const std::function<void(size_t)>& work) {
+    std::lock_guard<std::mutex> exclusive(running);
+    workers = std::min(std::max<size_t>(workers, 1), size());
+
+    if (workers > 1) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &work;
+            jobWorkers = workers;
+            pending = workers - 1;
+            generation++;
+        }
+        wake.notify_all();
+    }
+
+    work(0);
+
+    if (workers > 1) {
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [&] { return pending == 0; });
+        job = nullptr;
+    }
+}
+
+void WorkerPool::serve(size_t index) {
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true) {
+        wake.wait(lock, [&] { return stopping || generation != seen; });
+        if (stopping) return;
+        seen = generation;
+
+        // runs with fewer workers than threads leave the rest asleep
+        if (index >= jobWorkers) continue;
+
+        const std::function<void(size_t)>* work = job;
+        lock.unlock();
+        (*work)(index);
+        lock.lock();
+
+        if (--pending == 0) finished.notify_one();
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Process-wide set of threads that run the bodies of `parallel` loops.
+ * @details The threads are started on first use and then wait for work, so a
+ * loop that runs many times doesn't pay for starting threads each time. The
+ * thread calling run() takes part as worker 0, a machine with one core runs
+ * everything on the caller.
+ */
+class WorkerPool {
+public:
+    static WorkerPool& instance() {
+        static WorkerPool pool;
+        return pool;
+    }
+
+    /// Threads run() can use, the caller included.
+    size_t size() const { return helpers.size() + 1; }
+
+    /**
+     * @brief Calls work(0) .. work(workers - 1), each on its own thread.
+     * @details Returns once every call returned; work must not throw. One
+     * run() at a time, calls from other threads wait for the current one.
+     */
+    void run(size_t workers, const std::function<void(size_t)>& work);
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+private:
+    WorkerPool();
+    ~WorkerPool();
+
+    void serve(size_t index);
+
+    std::vector<std::thread> helpers;
+    std::mutex running;   // held for a whole run()
+    std::mutex mutex;     // guards the fields below
+    std::condition_variable wake;
+    std::condition_variable finished;
+    const std::function<void(size_t)>* job = nullptr;
+    size_t jobWorkers = 0;
+    size_t pending = 0;
+    uint64_t generation = 0;
+    bool stopping = false;
+};
@@ -94,6 +94,7 @@ void ArrayNode::compile(Emitter& e) const {
     e.emitByte(static_cast<uint8_t>(elements.size()));
 }
 
+void MapNode::compile(Emitter& e) const {}
 void RangeNode::compile(Emitter& e) const {}
 void IndexAccessNode::compile(Emitter& e) const {}
 void FunctionNode::compile(Emitter& e) const {}
@@ -1,231 +1,263 @@
 #include "lexer.h"
+#include "scan.h"
 
-std::vector<Token> tokenize(const std::string& input) {
-    std::vector<Token> tokens;
-    size_t i = 0;
-    int currentLine = 1;
+#include <charconv>
+
+namespace {
+    struct Keyword {
+        std::string_view text;
+        VTokenType type = VTokenType::Identifier;
+    };
+
+    constexpr Keyword KEYWORDS[] = {
+        {"out", VTokenType::BuiltIn},       {"sizeof", VTokenType::BuiltIn},
+        {"type", VTokenType::BuiltIn},      {"string", VTokenType::BuiltIn},
+        {"number", VTokenType::BuiltIn},    {"sequence", VTokenType::BuiltIn},
+        {"group", VTokenType::Group},       {"true", VTokenType::True},
+        {"false", VTokenType::False},       {"null", VTokenType::Null},
+        {"sub", VTokenType::Function},      {"return", VTokenType::Return},
+        {"while", VTokenType::While},       {"through", VTokenType::Through},
+        {"loop", VTokenType::LoopMode},     {"collect", VTokenType::LoopMode},
+        {"unique", VTokenType::LoopMode},   {"every", VTokenType::LoopMode},
+        {"filter", VTokenType::LoopMode},   {"break", VTokenType::Break},
+        {"continue", VTokenType::Continue}, {"module", VTokenType::Module},
+        {"dismiss", VTokenType::Dismiss},   {"if", VTokenType::If},
+        {"else", VTokenType::Else},         {"const", VTokenType::Const},
+        {"use", VTokenType::Use},           {"deploy", VTokenType::Deploy},
+        {"as", VTokenType::As},
+    };
+
+    constexpr size_t KEYWORD_SLOTS = 64;
 
-    while (i < input.length()) {
-        char character = input[i];
+    // first, second and last character plus the length; the multipliers are
+    // picked so every keyword gets a slot of its own (checked below)
+    constexpr size_t keywordHash(std::string_view word) {
+        return (static_cast<unsigned char>(word[0])
+              + 24u * static_cast<unsigned char>(word[1])
+              + 4u * static_cast<unsigned char>(word.back())
+              + word.size()) & (KEYWORD_SLOTS - 1);
+    }
+
+    struct KeywordTable {
+        Keyword slots[KEYWORD_SLOTS] = {};
+        bool perfect = true;
 
-        if (std::isspace(character)) {
-            if (character == '\n') {
-                currentLine++;
+        constexpr KeywordTable() {
+            for (const Keyword& kw : KEYWORDS) {
+                Keyword& slot = slots[keywordHash(kw.text)];
+                if (!slot.text.empty()) perfect = false;
+                slot = kw;
             }
-            i++;
+        }
+    };
+
+    constexpr KeywordTable KEYWORD_TABLE;
+    static_assert(KEYWORD_TABLE.perfect, "keyword hash collides, pick other multipliers");
+
+    /// One probe and one compare: there are no one-letter keywords.
+    VTokenType keywordType(std::string_view word) {
+        if (word.size() < 2) return VTokenType::Identifier;
+
+        const Keyword& kw = KEYWORD_TABLE.slots[keywordHash(word)];
+        return kw.text == word ? kw.type : VTokenType::Identifier;
+    }
+}
+
+std::string unescape(std::string_view raw) {
+    std::string text;
+    text.reserve(raw.size());
+
+    for (size_t i = 0; i < raw.size(); ++i) {
+        if (raw[i] == '\\' && i + 1 < raw.size()) {
+            char next = raw[i + 1];
+            if (next == 'n')  { text += '\n'; i++; continue; }
+            if (next == 't')  { text += '\t'; i++; continue; }
+            if (next == '"')  { text += '"';  i++; continue; }
+        }
+        text += raw[i];
+    }
+    return text;
+}
+
+Lexer::Lexer(const std::string& input) : source(input), scanner(activeScanner()) {}
+
+Token Lexer::next() {
+    const Scanner& scan = scanner;
+    const char* data = source.data();
+    const size_t length = source.length();
+
+    while (i < length) {
+        char character = source[i];
+
+        if (std::isspace(static_cast<unsigned char>(character))) {
+            i = scan.space(data, i, length, currentLine);
             continue;
         }
 
         if (character == '"') {
-            i++;
-            std::string strBuffer;
-
-            while (i < input.length() && input[i] != '"') {
-                if (input[i] == '\n') currentLine++;
-                if (input[i] == '\\' && i + 1 < input.length()) {
-                    if (input[i+1] == 'n') {
-                        strBuffer += '\n';
-                        i += 2;
-                        continue;
-                    } else if (input[i+1] == 't') {
-                        strBuffer += '\t';
-                        i += 2;
-                        continue;
-                    } else if (input[i+1] == '\"') {
-                        strBuffer += '\"';
-                        i += 2;
-                        continue;
-                    }
-                }
-                strBuffer += input[i];
-                i++;
-            }
+            // the token keeps the raw text between the quotes, escapes are resolved by unescape()
+            size_t start = ++i;
+            i = scan.string(data, i, length, currentLine);
 
-            if (i < input.length()) {
+            Token token(VTokenType::String, currentLine, 0, source.substr(start, i - start));
+            if (i < length) {
                 i++;
             }
-            tokens.emplace_back(Token(VTokenType::String, currentLine, 0, strBuffer));
-            continue;
+            return token;
         }
 
-        if (std::isdigit(character)) {
-            std::string buffer;
-            while (i < input.length()) {
-                if (std::isdigit(input[i])) {
-                    buffer += input[i++];
-                } else if (input[i] == '.') {
-                    if (i + 1 < input.length() && input[i + 1] == '.') {
+        if (std::isdigit(static_cast<unsigned char>(character))) {
+            size_t start = i;
+            while (i < length) {
+                if (std::isdigit(static_cast<unsigned char>(source[i]))) {
+                    i++;
+                } else if (source[i] == '.') {
+                    if (i + 1 < length && source[i + 1] == '.') {
                         break;
                     }
-                    buffer += input[i++];
+                    i++;
                 } else {
                     break;
                 }
             }
-            tokens.emplace_back(VTokenType::Number, currentLine, std::stod(buffer), "");
-            continue;
+
+            double number = 0.0;
+            std::from_chars(data + start, data + i, number);
+            return Token(VTokenType::Number, currentLine, number);
         }
-        if (std::isalpha(character) || character == '_') {
-            std::string buffer;
-            while (i < input.length() && (std::isalnum(input[i]) || input[i] == '_')) {
-                buffer += input[i++];
-            }
-
-            if (buffer == "out") tokens.emplace_back(VTokenType::BuiltIn, currentLine, 0, buffer);
-            else if (buffer == "sizeof") tokens.emplace_back(VTokenType::BuiltIn, currentLine, 0, buffer);
-            else if (buffer == "type") tokens.emplace_back(VTokenType::BuiltIn, currentLine, 0, buffer);
-            else if (buffer == "string") tokens.emplace_back(VTokenType::BuiltIn, currentLine, 0, buffer);
-            else if (buffer == "number") tokens.emplace_back(VTokenType::BuiltIn, currentLine, 0, buffer);
-            else if (buffer == "sequence") tokens.emplace_back(VTokenType::BuiltIn, currentLine, 0, buffer);
-            else if (buffer == "group") tokens.emplace_back(VTokenType::Group, currentLine, 0, "");
-            else if (buffer == "true") tokens.emplace_back(VTokenType::True, currentLine, 1, "");
-            else if (buffer == "false") tokens.emplace_back(VTokenType::False, currentLine, 0, "");
-            else if (buffer == "null") tokens.emplace_back(VTokenType::Null, currentLine, 0, "");
-            else if (buffer == "sub") tokens.emplace_back(VTokenType::Function, currentLine, 0, buffer);
-            else if (buffer == "return") tokens.emplace_back(VTokenType::Return, currentLine, 0, buffer);
-            else if (buffer == "while") tokens.emplace_back(VTokenType::While, currentLine, 0, buffer);
-            else if (buffer == "through") tokens.emplace_back(VTokenType::Through, currentLine, 0, buffer);
-            else if (buffer == "loop") tokens.emplace_back(VTokenType::LoopMode, currentLine, 0, buffer);
-            else if (buffer == "collect") tokens.emplace_back(VTokenType::LoopMode, currentLine, 0, buffer);
-            else if (buffer == "unique") tokens.emplace_back(VTokenType::LoopMode, currentLine, 0, buffer);
-            else if (buffer == "every") tokens.emplace_back(VTokenType::LoopMode, currentLine, 0, buffer);
-            else if (buffer == "filter") tokens.emplace_back(VTokenType::LoopMode, currentLine, 0, buffer);
-            else if (buffer == "break") tokens.emplace_back(VTokenType::Break, currentLine, 0, buffer);
-            else if (buffer == "continue") tokens.emplace_back(VTokenType::Continue, currentLine, 0, buffer);
-            else if (buffer == "module") tokens.emplace_back(VTokenType::Module, currentLine, 0, buffer);
-            else if (buffer == "dismiss") tokens.emplace_back(VTokenType::Dismiss, currentLine, 0, buffer);
-            else if (buffer == "if") tokens.emplace_back(VTokenType::If, currentLine, 0, buffer);
-            else if (buffer == "else") tokens.emplace_back(VTokenType::Else, currentLine, 0, buffer);
-            else if (buffer == "const") tokens.emplace_back(VTokenType::Const, currentLine, 0, buffer);
-            else if (buffer == "use") tokens.emplace_back(VTokenType::Use, currentLine, 0, buffer);
-            else if (buffer == "deploy") tokens.emplace_back(VTokenType::Deploy, currentLine, 0, buffer);
-            else if (buffer == "as") tokens.emplace_back(VTokenType::As, currentLine, 0, buffer);
-            else tokens.emplace_back(VTokenType::Identifier, currentLine, 0, buffer);
-            continue;
+        if (std::isalpha(static_cast<unsigned char>(character)) || character == '_') {
+            size_t start = i;
+            i = scan.ident(data, i + 1, length);
+
+            std::string_view word = source.substr(start, i - start);
+            VTokenType type = keywordType(word);
+            return Token(type, currentLine, type == VTokenType::True ? 1 : 0, word);
         }
 
+        // symbols; '#' comments, a lone '&' or '|' and unknown characters leave it as End
+        Token token;
         switch (character) {
-            case '(': tokens.emplace_back(VTokenType::Left_Parenthese, currentLine, 0, "("); break;
-            case ')': tokens.emplace_back(VTokenType::Right_Parenthese, currentLine, 0, ")"); break;
-            case '{': tokens.emplace_back(VTokenType::Left_CB, currentLine, 0, "{"); break;
-            case '}': tokens.emplace_back(VTokenType::Right_CB, currentLine, 0, "}"); break;
-            case '[': tokens.emplace_back(VTokenType::Left_Bracket, currentLine, 0, "["); break;
-            case ']': tokens.emplace_back(VTokenType::Right_Bracket, currentLine, 0, "]"); break;
-            case ',': tokens.emplace_back(VTokenType::Comma, currentLine, 0, ","); break;
-            case ';': tokens.emplace_back(VTokenType::Semicolon, currentLine, 0, ";"); break;
-            case '%': tokens.emplace_back(VTokenType::Modulo, currentLine, 0, "%"); break;
+            case '(': token = Token(VTokenType::Left_Parenthese, currentLine, 0, "("); break;
+            case ')': token = Token(VTokenType::Right_Parenthese, currentLine, 0, ")"); break;
+            case '{': token = Token(VTokenType::Left_CB, currentLine, 0, "{"); break;
+            case '}': token = Token(VTokenType::Right_CB, currentLine, 0, "}"); break;
+            case '[': token = Token(VTokenType::Left_Bracket, currentLine, 0, "["); break;
+            case ']': token = Token(VTokenType::Right_Bracket, currentLine, 0, "]"); break;
+            case ',': token = Token(VTokenType::Comma, currentLine, 0, ","); break;
+            case ';': token = Token(VTokenType::Semicolon, currentLine, 0, ";"); break;
+            case '%': token = Token(VTokenType::Modulo, currentLine, 0, "%"); break;
             case '/': {
-                if (i + 1 < input.length() && input[i + 1] == '/') {
-                    tokens.emplace_back(VTokenType::Floor_Divide, currentLine, 0, "//");
+                if (i + 1 < length && source[i + 1] == '/') {
+                    token = Token(VTokenType::Floor_Divide, currentLine, 0, "//");
                     i++;
                 } else {
-                    tokens.emplace_back(VTokenType::Division, currentLine, 0, "/");
+                    token = Token(VTokenType::Division, currentLine, 0, "/");
                 }
                 break;
             }
             case '.': {
-                if (i + 1 < input.length() && input[i + 1] == '.') {
-                    tokens.emplace_back(VTokenType::Double_Dot, currentLine, 0, "..");
+                if (i + 1 < length && source[i + 1] == '.') {
+                    token = Token(VTokenType::Double_Dot, currentLine, 0, "..");
                     i++;
                 } else {
-                    tokens.emplace_back(VTokenType::Dot, currentLine, 0, ".");
+                    token = Token(VTokenType::Dot, currentLine, 0, ".");
                 }
                 break;
             }
             case '*': {
-                if (i + 1 < input.length() && input[i + 1] == '*') {
-                    tokens.emplace_back(VTokenType::Power, currentLine, 0, "**");
+                if (i + 1 < length && source[i + 1] == '*') {
+                    token = Token(VTokenType::Power, currentLine, 0, "**");
                     i++;
                 } else {
-                    tokens.emplace_back(VTokenType::Multiply, currentLine, 0, "*");
+                    token = Token(VTokenType::Multiply, currentLine, 0, "*");
                 }
                 break;
             }
             case '+': {
-                if (i + 1 < input.length() && input[i + 1] == '+') {
-                    tokens.emplace_back(VTokenType::Double_Increment, currentLine, 0, "++");
+                if (i + 1 < length && source[i + 1] == '+') {
+                    token = Token(VTokenType::Double_Increment, currentLine, 0, "++");
                     i++;
                 } else {
-                    tokens.emplace_back(VTokenType::Add, currentLine, 0, "+");
+                    token = Token(VTokenType::Add, currentLine, 0, "+");
                 }
                 break;
             }
             case '<': {
-                if (i + 1 < input.length() && input[i + 1] == '=') {
-                    tokens.emplace_back(VTokenType::Smaller_Or_Equal, currentLine, 0, "<=");
+                if (i + 1 < length && source[i + 1] == '=') {
+                    token = Token(VTokenType::Smaller_Or_Equal, currentLine, 0, "<=");
                     i++;
                 } else {
-                    tokens.emplace_back(VTokenType::Smaller, currentLine, 0, "<");
+                    token = Token(VTokenType::Smaller, currentLine, 0, "<");
                 }
                 break;
             }
             case '>': {
-                if (i + 1 < input.length() && input[i + 1] == '=') {
-                    tokens.emplace_back(VTokenType::Greater_Or_Equal, currentLine, 0, ">=");
+                if (i + 1 < length && source[i + 1] == '=') {
+                    token = Token(VTokenType::Greater_Or_Equal, currentLine, 0, ">=");
                     i++;
                 } else {
-                    tokens.emplace_back(VTokenType::Greater, currentLine, 0, ">");
+                    token = Token(VTokenType::Greater, currentLine, 0, ">");
                 }
                 break;
             }
             case '=': {
-                if (i + 1 < input.length() && input[i + 1] == '=') {
-                    tokens.emplace_back(VTokenType::Double_Equals, currentLine, 0, "==");
+                if (i + 1 < length && source[i + 1] == '=') {
+                    token = Token(VTokenType::Double_Equals, currentLine, 0, "==");
                     i++;
                 } else {
-                    tokens.emplace_back(VTokenType::Equals, currentLine, 0, "=");
+                    token = Token(VTokenType::Equals, currentLine, 0, "=");
                 }
                 break;
             }
             case '!' : {
-                if (i + 1 < input.length() && input[i + 1] == '=') {
-                    tokens.emplace_back(VTokenType::Not_Equal, currentLine, 0, "!=");
+                if (i + 1 < length && source[i + 1] == '=') {
+                    token = Token(VTokenType::Not_Equal, currentLine, 0, "!=");
                     i++;
                 } else {
-                    tokens.emplace_back(VTokenType::Exclamatory, currentLine, 0, "!");
+                    token = Token(VTokenType::Exclamatory, currentLine, 0, "!");
                 }
                 break;
             }
             case '#': {
-                while (i < input.length() && input[i] != '\n') {
-                    i++;
-                }
+                i = scan.line(data, i, length);
                 i--; 
                 break;  
             }
             case ':' : {
-                if(i + 1 < input.length() && input[i + 1] == ':'){
-                    tokens.emplace_back(VTokenType::Extends, currentLine, 0, "::");
+                if(i + 1 < length && source[i + 1] == ':'){
+                    token = Token(VTokenType::Extends, currentLine, 0, "::");
                     i++;
+                } else {
+                    token = Token(VTokenType::Colon, currentLine, 0, ":");
                 }
                 break;
             }
             case '&' : {
-                if(i + 1 < input.length() && input[i + 1] == '&'){
-                    tokens.emplace_back(VTokenType::And, currentLine, 0, "&&");
+                if(i + 1 < length && source[i + 1] == '&'){
+                    token = Token(VTokenType::And, currentLine, 0, "&&");
                     i++;
                 }
                 break;
             }
             case '|' : {
-                if(i + 1 < input.length() && input[i + 1] == '|'){
-                    tokens.emplace_back(VTokenType::Or, currentLine, 0, "||");
+                if(i + 1 < length && source[i + 1] == '|'){
+                    token = Token(VTokenType::Or, currentLine, 0, "||");
                     i++;
-                } else if(i + 1 < input.length() && input[i + 1] == '>'){
-                    tokens.emplace_back(VTokenType::Pipeline, currentLine, 0, "|>");
+                } else if(i + 1 < length && source[i + 1] == '>'){
+                    token = Token(VTokenType::Pipeline, currentLine, 0, "|>");
                     i++;
                 }
                 break;
             }
             case '-' : {
-                if(i + 1 < input.length() && input[i + 1] == '>'){
-                    tokens.emplace_back(VTokenType::Arrow, currentLine, 0, "->");
+                if(i + 1 < length && source[i + 1] == '>'){
+                    token = Token(VTokenType::Arrow, currentLine, 0, "->");
                     i++;
-                } else if(i + 1 < input.length() && input[i + 1] == '-'){
-                    tokens.emplace_back(VTokenType::Double_Decrement, currentLine, 0, "--");
+                } else if(i + 1 < length && source[i + 1] == '-'){
+                    token = Token(VTokenType::Double_Decrement, currentLine, 0, "--");
                     i++;
                 } else {
-                    tokens.emplace_back(VTokenType::Substract, currentLine, 0, "-");
+                    token = Token(VTokenType::Substract, currentLine, 0, "-");
                 }
                 break;
             }
@@ -234,8 +266,19 @@ std::vector<Token> tokenize(const std::string& input) {
                 break;
         }
         i++;
+        if (token.type != VTokenType::End) return token;
     }
 
-    tokens.emplace_back(VTokenType::End, currentLine, 0, "");
+    return Token(VTokenType::End, currentLine, 0, "");
+}
+
+std::vector<Token> tokenize(const std::string& input) {
+    Lexer lexer(input);
+    std::vector<Token> tokens;
+    tokens.reserve(input.length() / 8 + 16);   // typical code has a token every 4-8 bytes, skip the first regrowths
+
+    do {
+        tokens.push_back(lexer.next());
+    } while (tokens.back().type != VTokenType::End);
     return tokens;
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <cctype>
 
 enum class VTokenType {
@@ -64,6 +65,7 @@ enum class VTokenType {
     Left_Bracket,       // [
     Right_Bracket,      // ]
     Comma,              // ,
+    Colon,              // :
     Semicolon,          // ;
     Dot,                // .
     Double_Dot,         // ..
@@ -73,20 +75,57 @@ enum class VTokenType {
     End                 // End of File (EOF)
 };
 
+/**
+ * @brief One lexeme of the source.
+ * @details name is a view into the buffer that was tokenized, it holds the
+ * identifier/keyword spelling, or the raw text between the quotes of a string
+ * literal (see unescape()).
+ */
 struct Token {
-    std::string name;
+    std::string_view name;
     double value;
     VTokenType type;
     int line;
 
-    Token(VTokenType t, int cl, double v = 0.0, const std::string& n = "")
+    Token(VTokenType t, int cl, double v = 0.0, std::string_view n = {})
         : type(t), value(v), name(n), line(cl) {
     }
 
-    Token() : type(VTokenType::End), value(0.0), name(""), line(0) {}
+    Token() : type(VTokenType::End), value(0.0), name(), line(0) {}
 };
 
+struct Scanner;
+
+/**
+ * @brief Pull-based tokenizer: hands out one token per next() call.
+ * @details Tokens view into the source string, which must outlive them; the
+ * lexer keeps no tokens itself. After the last token, next() keeps returning
+ * End.
+ */
+class Lexer {
+public:
+    explicit Lexer(const std::string& input);
+    Lexer(std::string&&) = delete;   // tokens would view a dead buffer
+
+    Token next();
+
+private:
+    std::string_view source;
+    const Scanner& scanner;
+    size_t i = 0;
+    int currentLine = 1;
+};
+
+/**
+ * @brief Runs a Lexer over input and collects every token, End included.
+ * @details Token names point into input, so it must outlive the tokens. The
+ * parser doesn't need this: it pulls from a Lexer as it goes.
+ */
 std::vector<Token> tokenize(const std::string& input);
+std::vector<Token> tokenize(std::string&&) = delete;
+
+/// Resolves the \n, \t and \" escapes of a raw string literal token.
+std::string unescape(std::string_view raw);
 char advance();
 
 inline std::string VTokenTypeToString(VTokenType type) {
@@ -149,6 +188,7 @@ inline std::string VTokenTypeToString(VTokenType type) {
         case VTokenType::Left_Bracket:     return "'['";
         case VTokenType::Right_Bracket:    return "']'";
         case VTokenType::Comma:            return "','";
+        case VTokenType::Colon:            return "':'";
         case VTokenType::Semicolon:        return "';'";
         case VTokenType::Dot:              return "'.'";
         case VTokenType::Double_Dot:       return "'..'";
@@ -0,0 +1,242 @@
+#include "scan.h"
+
+#include <cstdint>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define VYNE_SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+    inline bool isSpace(unsigned char c) {
+        return c == ' ' || (c >= '\t' && c <= '\r');
+    }
+
+    inline bool isIdent(unsigned char c) {
+        unsigned char lower = c | 0x20;
+        return (c >= '0' && c <= '9') || (lower >= 'a' && lower <= 'z') || c == '_';
+    }
+
+    // --- scalar: the reference every vector version must agree with ---
+
+    size_t spaceScalar(const char* s, size_t i, size_t n, int& lines) {
+        while (i < n && isSpace(s[i])) {
+            if (s[i] == '\n') lines++;
+            i++;
+        }
+        return i;
+    }
+
+    size_t identScalar(const char* s, size_t i, size_t n) {
+        while (i < n && isIdent(s[i])) i++;
+        return i;
+    }
+
+    size_t lineScalar(const char* s, size_t i, size_t n) {
+        while (i < n && s[i] != '\n') i++;
+        return i;
+    }
+
+    size_t stringScalar(const char* s, size_t i, size_t n, int& lines) {
+        while (i < n && s[i] != '"') {
+            if (s[i] == '\n') lines++;
+            if (s[i] == '\\' && i + 1 < n && s[i + 1] == '"') i++;
+            i++;
+        }
+        return i;
+    }
+
+    const Scanner SCALAR{"scalar", spaceScalar, identScalar, lineScalar, stringScalar};
+
+#ifdef VYNE_SCAN_X86
+    // Bytes >= 0x80 are negative as signed chars, so the signed range compares
+    // below never count them as ASCII classes, just like the scalar checks.
+
+    // --- SSE2: 16 bytes per step, always there on x86-64 ---
+
+    inline __m128i inRange16(__m128i v, char lo, char hi) {
+        return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(lo - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8(hi + 1)));
+    }
+
+    inline unsigned mask16(__m128i v, char c) {
+        return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(c))));
+    }
+
+    inline __m128i load16(const char* p) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
+
+    size_t spaceSse2(const char* s, size_t i, size_t n, int& lines) {
+        for (; i + 16 <= n; i += 16) {
+            __m128i v = load16(s + i);
+            unsigned space = static_cast<unsigned>(_mm_movemask_epi8(inRange16(v, '\t', '\r'))) | mask16(v, ' ');
+            unsigned stop = ~space & 0xFFFFu;
+            unsigned newlines = mask16(v, '\n');
+
+            if (stop) {
+                unsigned at = __builtin_ctz(stop);
+                lines += __builtin_popcount(newlines & ((1u << at) - 1));
+                return i + at;
+            }
+            lines += __builtin_popcount(newlines);
+        }
+        return spaceScalar(s, i, n, lines);
+    }
+
+    size_t identSse2(const char* s, size_t i, size_t n) {
+        for (; i + 16 <= n; i += 16) {
+            __m128i v = load16(s + i);
+            __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+            __m128i ident = _mm_or_si128(inRange16(v, '0', '9'), inRange16(lower, 'a', 'z'));
+            unsigned stop = ~(static_cast<unsigned>(_mm_movemask_epi8(ident)) | mask16(v, '_')) & 0xFFFFu;
+
+            if (stop) return i + __builtin_ctz(stop);
+        }
+        return identScalar(s, i, n);
+    }
+
+    size_t lineSse2(const char* s, size_t i, size_t n) {
+        for (; i + 16 <= n; i += 16) {
+            unsigned stop = mask16(load16(s + i), '\n');
+            if (stop) return i + __builtin_ctz(stop);
+        }
+        return lineScalar(s, i, n);
+    }
+
+    size_t stringSse2(const char* s, size_t i, size_t n, int& lines) {
+        while (i + 16 <= n) {
+            __m128i v = load16(s + i);
+            unsigned stop = mask16(v, '"') | mask16(v, '\\');
+            unsigned newlines = mask16(v, '\n');
+
+            if (!stop) {
+                lines += __builtin_popcount(newlines);
+                i += 16;
+                continue;
+            }
+
+            unsigned at = __builtin_ctz(stop);
+            lines += __builtin_popcount(newlines & ((1u << at) - 1));
+            i += at;
+
+            if (s[i] == '"') return i;
+            i += (i + 1 < n && s[i + 1] == '"') ? 2 : 1;
+        }
+        return stringScalar(s, i, n, lines);
+    }
+
+    const Scanner SSE2{"sse2", spaceSse2, identSse2, lineSse2, stringSse2};
+
+    // --- AVX2: 32 bytes per step, only used when the CPU reports it ---
+
+#define VYNE_AVX2 __attribute__((target("avx2")))
+
+    VYNE_AVX2 inline __m256i inRange32(__m256i v, char lo, char hi) {
+        return _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(lo - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8(hi + 1), v));
+    }
+
+    VYNE_AVX2 inline uint32_t mask32(__m256i v, char c) {
+        return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(c))));
+    }
+
+    VYNE_AVX2 inline __m256i load32(const char* p) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+
+    VYNE_AVX2 size_t spaceAvx2(const char* s, size_t i, size_t n, int& lines) {
+        for (; i + 32 <= n; i += 32) {
+            __m256i v = load32(s + i);
+            uint32_t space = static_cast<uint32_t>(_mm256_movemask_epi8(inRange32(v, '\t', '\r'))) | mask32(v, ' ');
+            uint32_t stop = ~space;
+            uint32_t newlines = mask32(v, '\n');
+
+            if (stop) {
+                unsigned at = __builtin_ctz(stop);
+                lines += __builtin_popcount(newlines & ((1u << at) - 1));
+                return i + at;
+            }
+            lines += __builtin_popcount(newlines);
+        }
+        return spaceSse2(s, i, n, lines);
+    }
+
+    VYNE_AVX2 size_t identAvx2(const char* s, size_t i, size_t n) {
+        for (; i + 32 <= n; i += 32) {
+            __m256i v = load32(s + i);
+            __m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+            __m256i ident = _mm256_or_si256(inRange32(v, '0', '9'), inRange32(lower, 'a', 'z'));
+            uint32_t stop = ~(static_cast<uint32_t>(_mm256_movemask_epi8(ident)) | mask32(v, '_'));
+
+            if (stop) return i + __builtin_ctz(stop);
+        }
+        return identSse2(s, i, n);
+    }
+
+    VYNE_AVX2 size_t lineAvx2(const char* s, size_t i, size_t n) {
+        for (; i + 32 <= n; i += 32) {
+            uint32_t stop = mask32(load32(s + i), '\n');
+            if (stop) return i + __builtin_ctz(stop);
+        }
+        return lineSse2(s, i, n);
+    }
+
+    VYNE_AVX2 size_t stringAvx2(const char* s, size_t i, size_t n, int& lines) {
+        while (i + 32 <= n) {
+            __m256i v = load32(s + i);
+            uint32_t stop = mask32(v, '"') | mask32(v, '\\');
+            uint32_t newlines = mask32(v, '\n');
+
+            if (!stop) {
+                lines += __builtin_popcount(newlines);
+                i += 32;
+                continue;
+            }
+
+            unsigned at = __builtin_ctz(stop);
+            lines += __builtin_popcount(newlines & ((1u << at) - 1));
+            i += at;
+
+            if (s[i] == '"') return i;
+            i += (i + 1 < n && s[i + 1] == '"') ? 2 : 1;
+        }
+        return stringSse2(s, i, n, lines);
+    }
+
+#undef VYNE_AVX2
+
+    const Scanner AVX2{"avx2", spaceAvx2, identAvx2, lineAvx2, stringAvx2};
+
+    bool hasAvx2() {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+    }
+#endif
+
+    const Scanner*& activeSlot() {
+        static const Scanner* slot = availableScanners().back();
+        return slot;
+    }
+}
+
+const Scanner& activeScanner() {
+    return *activeSlot();
+}
+
+std::vector<const Scanner*> availableScanners() {
+    std::vector<const Scanner*> scanners{&SCALAR};
+#ifdef VYNE_SCAN_X86
+    scanners.push_back(&SSE2);
+    if (hasAvx2()) scanners.push_back(&AVX2);
+#endif
+    return scanners;
+}
+
+bool selectScanner(const std::string& name) {
+    for (const Scanner* scanner : availableScanners()) {
+        if (name == scanner->name) {
+            activeSlot() = scanner;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The lexer's hot inner loops, as one table of function pointers.
+ * @details Every routine starts at index i of a buffer of length n and returns
+ * the index where its run ends (n if it runs off the end). Routines that may
+ * cross line breaks add the '\n's they pass to lines.
+ * * The best implementation the CPU supports (AVX2, SSE2, then plain scalar
+ * code) is picked once at startup; they all return the same positions.
+ */
+struct Scanner {
+    const char* name;
+
+    /// First byte that isn't whitespace (' ', '\t' .. '\r').
+    size_t (*space)(const char* s, size_t i, size_t n, int& lines);
+    /// First byte that can't continue an identifier ([A-Za-z0-9_]).
+    size_t (*ident)(const char* s, size_t i, size_t n);
+    /// The '\n' that ends a comment.
+    size_t (*line)(const char* s, size_t i, size_t n);
+    /// The '"' closing a string literal; a \" inside it doesn't close it.
+    size_t (*string)(const char* s, size_t i, size_t n, int& lines);
+};
+
+/// The scanner tokenize() uses.
+const Scanner& activeScanner();
+
+/// Every scanner this CPU can run, slowest first.
+std::vector<const Scanner*> availableScanners();
+
+/// Makes the named scanner active, false if it isn't available here.
+bool selectScanner(const std::string& name);
@@ -1,6 +1,8 @@
 #include "parser.h"
 #include "../ast/value.h"
 
+#include <array>
+
 #define RESET   "\033[0m"
 #define RED     "\033[31m"
 #define GREEN   "\033[32m"
@@ -14,58 +16,76 @@ class StringPool;
 
 // TODO ADD DOUBLE INCREMENT SYNTAX
 
-Token Parser::getNextToken() {
-    if (pos < tokens.size()) {
-        return tokens[pos++];
+bool Parser::fill(size_t distance) {
+    while (buffered <= distance) {
+        if (drained) return false;
+
+        if (buffered == ring.size()) {
+            std::vector<Token> grown(ring.size() * 2);
+            for (size_t k = 0; k < buffered; ++k) {
+                grown[k] = ring[(head + k) & (ring.size() - 1)];
+            }
+            ring = std::move(grown);
+            head = 0;
+        }
+
+        Token t = lexer.next();
+        drained = t.type == VTokenType::End;
+        ring[(head + buffered++) & (ring.size() - 1)] = t;
     }
-    return Token(VTokenType::End, 0, 0, "");
+    return true;
 }
 
-Token Parser::peekToken() {
-    if (pos < tokens.size()) {
-        return tokens[pos];
+const Token Parser::END(VTokenType::End, 0, 0, "");
+
+const Token& Parser::getNextToken() {
+    if (buffered || fill(0)) {
+        const Token& t = ring[head];
+        head = (head + 1) & (ring.size() - 1);
+        buffered--;
+        return t;
     }
-    return Token(VTokenType::End, 0, 0, "");
+    return END;
 }
 
-Token Parser::lookAhead(int distance) {
-    if (pos + distance < tokens.size()) {
-        return tokens[pos + distance];
+const Token& Parser::lookAhead(int distance) {
+    if (fill(distance)) {
+        return ring[(head + distance) & (ring.size() - 1)];
     }
-    return Token(VTokenType::End, 0, 0, "");
+    return END;
 }
 
 
-Token Parser::consume(VTokenType expected) {
-    Token t = peekToken();
+const Token& Parser::consume(VTokenType expected) {
+    const Token& t = peekToken();
     if (t.type == expected) {
-        return tokens[pos++];
+        return getNextToken();
     }
     throw std::runtime_error("Error: Unexpected token type! Expected " +
         VTokenTypeToString(expected) + ", but got " +
-        VTokenTypeToString(peekToken().type) + " instead [ line " + std::to_string(t.line) + " ]");
+        VTokenTypeToString(t.type) + " instead [ line " + std::to_string(t.line) + " ]");
 }
 
-std::unique_ptr<ASTNode> Parser::parseDeployModule() {
+ASTNode* Parser::parseDeployModule() {
     int line = peekToken().line;
     consume(VTokenType::Deploy);
 
     Token modTok = consume(VTokenType::Identifier);
-    std::string moduleName = modTok.name;
+    std::string moduleName(modTok.name);
 
     consumeSemicolon();
 
-    auto node = std::make_unique<DeployNode>(moduleName);
+    auto node = arena->make<DeployNode>(moduleName);
     node->lineNumber = line;
     return node;
 }
 
-std::unique_ptr<ASTNode> Parser::parseImportModule() {
+ASTNode* Parser::parseImportModule() {
     int line = peekToken().line;
     consume(VTokenType::Use);
 
     Token pathTok = consume(VTokenType::String);
-    std::string filePath = pathTok.name;
+    std::string filePath = unescape(pathTok.name);
 
     std::string alias = "";
     if (peekToken().type == VTokenType::As) {
@@ -75,7 +95,8 @@ std::unique_ptr<ASTNode> Parser::parseImportModule() {
 
     consumeSemicolon();
 
-    auto node = std::make_unique<ImportNode>(filePath, alias);
+    importPaths.push_back(filePath);
+    auto node = arena->make<ImportNode>(filePath, alias);
     node->lineNumber = line;
     return node;
 }
@@ -87,21 +108,23 @@ void Parser::consumeSemicolon() {
     } else if (t.type != VTokenType::End && t.type != VTokenType::Right_CB) {
         throw std::runtime_error("Runtime/Compilation Error: Expected ';' at end of statement on line " 
             + std::to_string(t.line) + 
-            ", but got '" + t.name + "' instead.");
+            ", but got '" + std::string(t.name) + "' instead.");
     }
 }
 
-std::unique_ptr<ProgramNode> Parser::parseProgram() {
-    std::vector<std::shared_ptr<ASTNode>> statements;
+std::shared_ptr<ProgramNode> Parser::parseProgram() {
+    std::vector<ASTNode*> statements;
     while (peekToken().type != VTokenType::End) {
         statements.emplace_back(parseStatement());
     }
-    return std::make_unique<ProgramNode>(std::move(statements));
+    return std::shared_ptr<ProgramNode>(arena, arena->make<ProgramNode>(arena->list(statements)));
 }
 
-std::unique_ptr<ASTNode> Parser::parseStatement() {
+ASTNode* Parser::parseStatement() {
     Token current = peekToken();
     
+    if (atMemoSub()) return parseFunctionDefinition();
+
     switch (current.type) {
         case VTokenType::Function:   return parseFunctionDefinition();
         case VTokenType::Left_CB:    return parseBlock();
@@ -163,111 +186,91 @@ std::unique_ptr<ASTNode> Parser::parseStatement() {
     }
 }
 
-std::unique_ptr<ASTNode> Parser::parseExpression() {
-    return parseRange();
-}
-
-std::unique_ptr<ASTNode> Parser::parseRange() {
-    auto left = parseLogicalOr();
-    
-    while (peekToken().type == VTokenType::Double_Dot) {
-        Token opToken = getNextToken();
-        auto right = parseLogicalOr();
-        left = std::make_unique<RangeNode>(std::move(left), std::move(right));
-    }
-    return left;
-}
-
-std::unique_ptr<ASTNode> Parser::parseLogicalOr() {
-    auto left = parseLogicalAnd();
-    while (peekToken().type == VTokenType::Or) {
-        Token opToken = getNextToken();
-        auto right = parseLogicalAnd();
-        left = std::make_unique<BinOpNode>(VTokenType::Or, std::move(left), std::move(right));
-    }
-    return left;
-}
-
-std::unique_ptr<ASTNode> Parser::parseLogicalAnd() {
-    auto left = parseEquality();
-    while (peekToken().type == VTokenType::And) {
-        Token opToken = getNextToken();
-        auto right = parseEquality();
-        left = std::make_unique<BinOpNode>(VTokenType::And, std::move(left), std::move(right));
-    }
-    return left;
-}
-
-std::unique_ptr<ASTNode> Parser::parseEquality() {
-    auto left = parseRelational();
-    while (peekToken().type == VTokenType::Double_Equals || peekToken().type == VTokenType::Not_Equal) {
-        Token opToken = getNextToken();
-        auto right = parseRelational();
-        left = std::make_unique<BinOpNode>(opToken.type, std::move(left), std::move(right));
-    }
-    return left;
-}
-
-std::unique_ptr<ASTNode> Parser::parseRelational() {
-    auto left = parseAdditive();
-    while (peekToken().type == VTokenType::Greater || peekToken().type == VTokenType::Smaller || 
-           peekToken().type == VTokenType::Greater_Or_Equal || peekToken().type == VTokenType::Smaller_Or_Equal) {
-        Token opToken = getNextToken();
-        auto right = parseAdditive();
-        left = std::make_unique<BinOpNode>(opToken.type, std::move(left), std::move(right));
+namespace {
+    constexpr int TERM_POWER = 7;
+
+    // How tightly each binary operator binds, 0 for tokens that can't continue
+    // an expression. Same levels as the old one-function-per-level descent:
+    // '..' < '||' < '&&' < equality < relational < additive < multiplicative.
+    constexpr std::array<int, static_cast<size_t>(VTokenType::End) + 1> INFIX_POWER = [] {
+        std::array<int, static_cast<size_t>(VTokenType::End) + 1> power{};
+        auto set = [&](VTokenType type, int level) { power[static_cast<size_t>(type)] = level; };
+
+        set(VTokenType::Double_Dot, 1);
+        set(VTokenType::Or, 2);
+        set(VTokenType::And, 3);
+        set(VTokenType::Double_Equals, 4);
+        set(VTokenType::Not_Equal, 4);
+        set(VTokenType::Greater, 5);
+        set(VTokenType::Smaller, 5);
+        set(VTokenType::Greater_Or_Equal, 5);
+        set(VTokenType::Smaller_Or_Equal, 5);
+        set(VTokenType::Add, 6);
+        set(VTokenType::Substract, 6);
+        set(VTokenType::Floor_Divide, 6);
+        set(VTokenType::Modulo, 6);
+        set(VTokenType::Multiply, TERM_POWER);
+        set(VTokenType::Division, TERM_POWER);
+        set(VTokenType::Power, TERM_POWER);
+        return power;
+    }();
+}
+
+ASTNode* Parser::parseExpression(int minPower) {
+    ASTNode* left = parseUnary();
+
+    while (true) {
+        const Token& op = peekToken();
+        int power = INFIX_POWER[static_cast<size_t>(op.type)];
+        if (power <= minPower) return left;
+
+        VTokenType type = op.type;
+        int line = op.line;
+        getNextToken();
+
+        // all operators are left-associative, so the right side only takes tighter ones
+        ASTNode* right = parseExpression(power);
+
+        if (type == VTokenType::Double_Dot) {
+            left = arena->make<RangeNode>(left, right);
+        } else {
+            auto node = arena->make<BinOpNode>(type, left, right);
+            if (power == TERM_POWER) node->lineNumber = line;
+            left = node;
+        }
     }
-    return left;
 }
 
-std::unique_ptr<ASTNode> Parser::parseAdditive() {
-    auto left = parseTerm();
-    while (peekToken().type == VTokenType::Add || peekToken().type == VTokenType::Substract || peekToken().type == VTokenType::Floor_Divide || peekToken().type == VTokenType::Modulo) {
-        Token opToken = getNextToken();
-        auto right = parseTerm();
-        left = std::make_unique<BinOpNode>(opToken.type, std::move(left), std::move(right));
-    }
-    return left;
-}
+ASTNode* Parser::parseUnary() {
+    const Token& current = peekToken();
+    if (current.type == VTokenType::Exclamatory || current.type == VTokenType::Substract) {
+        VTokenType op = current.type;
+        int line = current.line;
+        getNextToken();
 
-std::unique_ptr<ASTNode> Parser::parseTerm() {
-    auto left = parseUnary();
-    while (peekToken().type == VTokenType::Multiply || peekToken().type == VTokenType::Division || peekToken().type == VTokenType::Power) {
-        Token opToken = getNextToken();
         auto right = parseUnary();
-        auto node = std::make_unique<BinOpNode>(opToken.type, std::move(left), std::move(right));
-        node->lineNumber = opToken.line;
-        left = std::move(node);
-    }
-    return left;
-}
 
-std::unique_ptr<ASTNode> Parser::parseUnary() {
-    if (peekToken().type == VTokenType::Exclamatory || 
-        peekToken().type == VTokenType::Substract) {
-        Token opToken = getNextToken();
-        
-        auto right = parseUnary(); 
-
-        auto node = std::make_unique<UnaryNode>(opToken.type, std::move(right));
-        node->lineNumber = opToken.line;
+        auto node = arena->make<UnaryNode>(op, right);
+        node->lineNumber = line;
         return node;
     }
     return parsePostfix();
 }
 
-std::unique_ptr<ASTNode> Parser::parsePostfix() {
+ASTNode* Parser::parsePostfix() {
     auto left = parseFactor();
-    while (peekToken().type == VTokenType::Double_Increment || peekToken().type == VTokenType::Double_Decrement) {
-        Token opToken = getNextToken();
-        auto node = std::make_unique<PostFixNode>(opToken.type, std::move(left));
+    for (VTokenType type = peekToken().type; type == VTokenType::Double_Increment || type == VTokenType::Double_Decrement;
+         type = peekToken().type) {
+        const Token& opToken = getNextToken();
+        auto node = arena->make<PostFixNode>(opToken.type, left);
         node->lineNumber = opToken.line;
-        left = std::move(node);
+        left = node;
     }
     return left;
 }
 
-std::unique_ptr<ASTNode> Parser::parseFactor() {
-    Token current = peekToken(); 
+ASTNode* Parser::parseFactor() {
+    const Token& current = peekToken();
     switch (current.type) {
         case VTokenType::String:                  return parseStringLiteral();
         case VTokenType::Number:                  return parseNumberLiteral();
@@ -275,53 +278,54 @@ std::unique_ptr<ASTNode> Parser::parseFactor() {
         case VTokenType::False:                   return parseBooleanLiteral();
         case VTokenType::Identifier:              return parseIdentifierExpr();
         case VTokenType::Left_Bracket:            return parseArrayLiteral();
+        case VTokenType::Left_CB:                 return parseMapLiteral();
         case VTokenType::Left_Parenthese:         return parseGroupingExpr();
         case VTokenType::BuiltIn:                 return parseBuiltInCall();
         case VTokenType::Through:                 return parseForLoop();
         default:
-            throw std::runtime_error("Unexpected token in factor: " + current.name + "[ line " + std::to_string(current.line) + " ]");
+            throw std::runtime_error("Unexpected token in factor: " + std::string(current.name) + "[ line " + std::to_string(current.line) + " ]");
     }
 }
 
-std::unique_ptr<ASTNode> Parser::parseStringLiteral() {
+ASTNode* Parser::parseStringLiteral() {
     Token current = peekToken(); 
     int line = current.line;
 
     consume(VTokenType::String);
 
-    auto node = std::make_unique<StringNode>(current.name);
+    auto node = arena->make<StringNode>(unescape(current.name));
     node->lineNumber = line;
 
     return node;
 }
 
-std::unique_ptr<ASTNode> Parser::parseNumberLiteral(){
+ASTNode* Parser::parseNumberLiteral(){
     Token current = peekToken(); 
     int line = current.line;
 
     consume(VTokenType::Number);
-    auto node = std::make_unique<NumberNode>(current.value);
+    auto node = arena->make<NumberNode>(current.value);
     node->lineNumber = line;
     return node;
 }
 
-std::unique_ptr<ASTNode> Parser::parseBooleanLiteral() {
+ASTNode* Parser::parseBooleanLiteral() {
     Token tok = peekToken();
     bool value = (tok.type == VTokenType::True);
     consume(tok.type);
     
-    auto node = std::make_unique<BooleanNode>(value);
+    auto node = arena->make<BooleanNode>(value);
     node->lineNumber = tok.line;
     return node;
 }
 
-std::unique_ptr<ASTNode> Parser::parseArrayLiteral() {
+ASTNode* Parser::parseArrayLiteral() {
     Token tok = peekToken(); 
     int line = tok.line;
 
     consume(VTokenType::Left_Bracket);
     
-    std::vector<std::unique_ptr<ASTNode>> elements;
+    std::vector<ASTNode*> elements;
     
     if (peekToken().type != VTokenType::Right_Bracket) {
         elements.emplace_back(parseExpression());
@@ -334,19 +338,55 @@ std::unique_ptr<ASTNode> Parser::parseArrayLiteral() {
     
     consume(VTokenType::Right_Bracket);
 
-    auto node = std::make_unique<ArrayNode>(std::move(elements));
+    auto node = arena->make<ArrayNode>(arena->list(elements));
     node->lineNumber = line;
     return node;
 }
 
-std::unique_ptr<ASTNode> Parser::parseGroupingExpr() {
+ASTNode* Parser::parseMapLiteral() {
+    Token tok = peekToken();
+    int line = tok.line;
+
+    consume(VTokenType::Left_CB);
+
+    std::vector<MapEntryNode> entries;
+    auto parseEntry = [&]() {
+        auto key = parseExpression();
+        consume(VTokenType::Colon);
+        entries.push_back({key, parseExpression()});
+    };
+
+    if (peekToken().type != VTokenType::Right_CB) {
+        parseEntry();
+
+        while (peekToken().type == VTokenType::Comma) {
+            consume(VTokenType::Comma);
+            parseEntry();
+        }
+    }
+
+    consume(VTokenType::Right_CB);
+
+    auto node = arena->make<MapNode>(arena->list(entries));
+    node->lineNumber = line;
+    return node;
+}
+
+ASTNode* Parser::parseGroupingExpr() {
     consume(VTokenType::Left_Parenthese);
     auto node = parseExpression();
     consume(VTokenType::Right_Parenthese);
     return node;
 }
 
-std::unique_ptr<ASTNode> Parser::parseFunctionDefinition() {
+bool Parser::atMemoSub() {
+    return peekToken().type == VTokenType::Identifier && peekToken().name == "memo" && lookAhead(1).type == VTokenType::Function;
+}
+
+ASTNode* Parser::parseFunctionDefinition() {
+    bool memo = atMemoSub();
+    if (memo) consume(VTokenType::Identifier);
+
     Token funcTok = consume(VTokenType::Function);
     int line = funcTok.line;
     
@@ -394,24 +434,24 @@ std::unique_ptr<ASTNode> Parser::parseFunctionDefinition() {
     consume(VTokenType::Right_Parenthese);
 
     consume(VTokenType::Left_CB);
-    std::vector<std::shared_ptr<ASTNode>> body;
+    std::vector<ASTNode*> body;
     while (peekToken().type != VTokenType::Right_CB && peekToken().type != VTokenType::End) {
         body.emplace_back(parseStatement());
     }
     consume(VTokenType::Right_CB);
 
-    auto node = std::make_unique<FunctionNode>(targetModule, funcId, funcName, std::move(params), std::move(body));
+    auto node = arena->make<FunctionNode>(targetModule, funcId, funcName, std::move(params), arena->list(body), arena.get(), memo);
     node->lineNumber = line;
     return node;
 }
 
-std::unique_ptr<ASTNode> Parser::parseBuiltInCall() {
+ASTNode* Parser::parseBuiltInCall() {
     Token tok = consume(VTokenType::BuiltIn);
     int line = tok.line;
     
     consume(VTokenType::Left_Parenthese);
     
-    std::vector<std::unique_ptr<ASTNode>> args;
+    std::vector<ASTNode*> args;
     if (peekToken().type != VTokenType::Right_Parenthese) {
         do {
             if (peekToken().type == VTokenType::Comma) consume(VTokenType::Comma);
@@ -421,20 +461,20 @@ std::unique_ptr<ASTNode> Parser::parseBuiltInCall() {
     
     consume(VTokenType::Right_Parenthese);
     
-    auto node = std::make_unique<BuiltInCallNode>(tok.name, std::move(args));
+    auto node = arena->make<BuiltInCallNode>(std::string(tok.name), arena->list(args));
     node->lineNumber = line;
     return node;
 }
 
-std::unique_ptr<ASTNode> Parser::parseIdentifierExpr() {
+ASTNode* Parser::parseIdentifierExpr() {
     Token tok = consume(VTokenType::Identifier);
     int line = tok.line;
 
     if (tok.name == "return" || tok.name == "sub" || tok.name == "log") {
-        throw std::runtime_error("Syntax Error: Unexpected keyword '" + tok.name + "'");
+        throw std::runtime_error("Syntax Error: Unexpected keyword '" + std::string(tok.name) + "'");
     }   
 
-    std::string lastName = tok.name;
+    std::string lastName(tok.name);
     uint32_t currentId = StringPool::instance().intern(lastName);
 
     VType explicitType = VType::Unknown;
@@ -450,11 +490,11 @@ std::unique_ptr<ASTNode> Parser::parseIdentifierExpr() {
         defineSymbol(currentId, explicitType, true);
     }
     std::vector<std::string> scope;
-    std::unique_ptr<ASTNode> node;
+    ASTNode* node;
 
     if (peekToken().type == VTokenType::Left_Parenthese) {
         consume(VTokenType::Left_Parenthese);
-        std::vector<std::unique_ptr<ASTNode>> args;
+        std::vector<ASTNode*> args;
         if (peekToken().type != VTokenType::Right_Parenthese) {
             do {
                 if (peekToken().type == VTokenType::Comma) consume(VTokenType::Comma);
@@ -462,9 +502,9 @@ std::unique_ptr<ASTNode> Parser::parseIdentifierExpr() {
             } while (peekToken().type == VTokenType::Comma);
         }
         consume(VTokenType::Right_Parenthese);
-        node = std::make_unique<FunctionCallNode>(currentId, lastName, std::move(args));
+        node = arena->make<FunctionCallNode>(currentId, lastName, arena->list(args));
     } else {
-        node = std::make_unique<VariableNode>(currentId, tok.name, explicitType);
+        node = arena->make<VariableNode>(currentId, std::string(tok.name), explicitType);
     }
 
     while (peekToken().type == VTokenType::Dot || peekToken().type == VTokenType::Left_Bracket) {
@@ -474,7 +514,7 @@ std::unique_ptr<ASTNode> Parser::parseIdentifierExpr() {
 
             if (peekToken().type == VTokenType::Left_Parenthese) {
                 consume(VTokenType::Left_Parenthese);
-                std::vector<std::unique_ptr<ASTNode>> args;
+                std::vector<ASTNode*> args;
                 if (peekToken().type != VTokenType::Right_Parenthese) {
                     do {
                         if (peekToken().type == VTokenType::Comma) consume(VTokenType::Comma);
@@ -482,12 +522,12 @@ std::unique_ptr<ASTNode> Parser::parseIdentifierExpr() {
                     } while (peekToken().type == VTokenType::Comma);
                 }
                 consume(VTokenType::Right_Parenthese);
-                node = std::make_unique<MethodCallNode>(std::move(node), member.name, std::move(args));
+                node = arena->make<MethodCallNode>(node, std::string(member.name), arena->list(args));
             } else {
                 scope.emplace_back(lastName);
                 lastName = member.name;
                 uint32_t memberId = StringPool::instance().intern(member.name);
-                node = std::make_unique<VariableNode>(memberId, lastName, explicitType, scope);
+                node = arena->make<VariableNode>(memberId, lastName, explicitType, scope);
             }
         } 
         else if (peekToken().type == VTokenType::Left_Bracket) {
@@ -496,7 +536,7 @@ std::unique_ptr<ASTNode> Parser::parseIdentifierExpr() {
             consume(VTokenType::Right_Bracket);
             
             uint32_t lastId = StringPool::instance().intern(lastName);
-            node = std::make_unique<IndexAccessNode>(lastId, lastName, scope, std::move(indexExpr));
+            node = arena->make<IndexAccessNode>(lastId, lastName, scope, indexExpr);
         }
     }
 
@@ -504,22 +544,22 @@ std::unique_ptr<ASTNode> Parser::parseIdentifierExpr() {
     return node;
 }
 
-std::unique_ptr<ASTNode> Parser::parseBlock() {
+ASTNode* Parser::parseBlock() {
     int line = peekToken().line;
     consume(VTokenType::Left_CB);
     
-    std::vector<std::shared_ptr<ASTNode>> statements;
+    std::vector<ASTNode*> statements;
     while (peekToken().type != VTokenType::Right_CB && peekToken().type != VTokenType::End) {
         statements.emplace_back(parseStatement());
     }
     
     consume(VTokenType::Right_CB);
-    auto node = std::make_unique<BlockNode>(std::move(statements));
+    auto node = arena->make<BlockNode>(arena->list(statements));
     node->lineNumber = line;
     return node;
 }
 
-std::unique_ptr<ASTNode> Parser::parseIfStatement() {
+ASTNode* Parser::parseIfStatement() {
     int line = peekToken().line;
     consume(VTokenType::If);
     
@@ -527,7 +567,7 @@ std::unique_ptr<ASTNode> Parser::parseIfStatement() {
     
     auto body = parseStatement();
 
-    std::unique_ptr<ASTNode> elseBody = nullptr;
+    ASTNode* elseBody = nullptr;
     
     if (peekToken().type == VTokenType::Else) {
         consume(VTokenType::Else);
@@ -539,24 +579,24 @@ std::unique_ptr<ASTNode> Parser::parseIfStatement() {
         }
     }
 
-    auto node = std::make_unique<IfNode>(std::move(condition), std::move(body), std::move(elseBody));
+    auto node = arena->make<IfNode>(condition, body, elseBody);
     node->lineNumber = line;
     return node;
 }
 
-std::unique_ptr<ASTNode> Parser::parseWhileLoop() {
+ASTNode* Parser::parseWhileLoop() {
     int line = peekToken().line;
     consume(VTokenType::While);
     
     auto condition = parseExpression();
     
     auto body = parseStatement();
-    auto node = std::make_unique<WhileNode>(std::move(condition), std::move(body));
+    auto node = arena->make<WhileNode>(condition, body);
     node->lineNumber = line;
     return node;
 }
 
-std::unique_ptr<ASTNode> Parser::parseForLoop() {
+ASTNode* Parser::parseForLoop() {
     int line = peekToken().line;
     consume(VTokenType::Through);
     
@@ -573,21 +613,31 @@ std::unique_ptr<ASTNode> Parser::parseForLoop() {
         consume(VTokenType::Arrow);
     }
 
-    std::string modeStr = consume(VTokenType::LoopMode).name;
-    std::unique_ptr<ASTNode> body;
+    // `parallel` is only special right before a loop mode, it stays a usable name elsewhere
+    bool parallel = false;
+    if (peekToken().type == VTokenType::Identifier && peekToken().name == "parallel" && lookAhead(1).type == VTokenType::LoopMode) {
+        consume(VTokenType::Identifier);
+        parallel = true;
+    }
+
+    std::string modeStr(consume(VTokenType::LoopMode).name);
+    if (parallel && modeStr != "collect" && modeStr != "filter" && modeStr != "every") {
+        throw std::runtime_error("Syntax Error: 'parallel' works with collect, filter and every, not " + modeStr + " [ line " + std::to_string(line) + " ]");
+    }
+    ASTNode* body;
     
     if (peekToken().type == VTokenType::Left_CB) {
         body = parseBlock();
     } else {
-        body = std::make_unique<VariableNode>(StringPool::instance().intern(iteratorName), iteratorName);
+        body = arena->make<VariableNode>(StringPool::instance().intern(iteratorName), iteratorName);
     }
 
-    auto node = std::make_unique<ForNode>(std::move(iterable), std::move(body), iteratorName, ForNode::getForMode(modeStr));
+    auto node = arena->make<ForNode>(iterable, body, iteratorName, ForNode::getForMode(modeStr), parallel);
     node->lineNumber = line;
     return node;
 }
 
-std::unique_ptr<ASTNode> Parser::parseAssignment() {
+ASTNode* Parser::parseAssignment() {
     int line = peekToken().line;
     bool isConst = false;
 
@@ -603,7 +653,7 @@ std::unique_ptr<ASTNode> Parser::parseAssignment() {
     consumeSemicolon();
 
     if (lhsNode->type() == NodeType::VARIABLE) {
-        auto* var = static_cast<VariableNode*>(lhsNode.get());
+        auto* var = static_cast<VariableNode*>(lhsNode);
         uint32_t varId = var->getNameId();
         
         VType varType = var->getStaticType(); 
@@ -614,10 +664,10 @@ std::unique_ptr<ASTNode> Parser::parseAssignment() {
             defineScopedSymbol(var->getScope(), varId, varType, varType != VType::Unknown);
         }
 
-        auto node = std::make_unique<AssignmentNode>(
+        auto node = arena->make<AssignmentNode>(
             varId, 
             var->getOriginalName(), 
-            std::move(rhs), 
+            rhs, 
             isConst,
             varType,
             var->getScope()
@@ -630,16 +680,16 @@ std::unique_ptr<ASTNode> Parser::parseAssignment() {
     throw std::runtime_error("Syntax Error: Invalid assignment target.");
 }
 
-std::unique_ptr<ASTNode> Parser::parseGroupDefinition() {
+ASTNode* Parser::parseGroupDefinition() {
     int line = peekToken().line;
     consume(VTokenType::Group);
     
-    std::string treeName = consume(VTokenType::Identifier).name;
+    std::string treeName(consume(VTokenType::Identifier).name);
     consume(VTokenType::Left_CB);
     
-    std::vector<std::unique_ptr<ASTNode>> statements;
+    std::vector<ASTNode*> statements;
     while (peekToken().type != VTokenType::Right_CB && peekToken().type != VTokenType::End) {
-        if (peekToken().type == VTokenType::Function) {
+        if (peekToken().type == VTokenType::Function || atMemoSub()) {
             throw std::runtime_error("Syntax Error: Cannot define a function inside group '" + treeName + "' at line " + std::to_string(peekToken().line));
         }
         statements.emplace_back(parseStatement());
@@ -648,39 +698,39 @@ std::unique_ptr<ASTNode> Parser::parseGroupDefinition() {
     consume(VTokenType::Right_CB);
     consumeSemicolon();
 
-    auto node = std::make_unique<GroupNode>(treeName, std::move(statements));
+    auto node = arena->make<GroupNode>(treeName, arena->list(statements));
     node->lineNumber = line;
     return node;
 }
 
-std::unique_ptr<ASTNode> Parser::parseReturnStatement() {
+ASTNode* Parser::parseReturnStatement() {
     int line = peekToken().line;
     consume(VTokenType::Return);
     
     auto expr = parseExpression();
     consumeSemicolon();
     
-    auto node = std::make_unique<ReturnNode>(std::move(expr));
+    auto node = arena->make<ReturnNode>(expr);
     node->lineNumber = line;
     return node;
 }
 
-std::unique_ptr<ASTNode> Parser::parseLoopControl() {
+ASTNode* Parser::parseLoopControl() {
     Token tok = getNextToken();
     consumeSemicolon();
     
-    std::unique_ptr<ASTNode> node;
+    ASTNode* node;
     if (tok.type == VTokenType::Break) {
-        node = std::make_unique<BreakNode>();
+        node = arena->make<BreakNode>();
     } else {
-        node = std::make_unique<ContinueNode>();
+        node = arena->make<ContinueNode>();
     }
     
     node->lineNumber = tok.line;
     return node;
 }
 
-std::unique_ptr<ASTNode> Parser::parseModuleStatement() {
+ASTNode* Parser::parseModuleStatement() {
     int line = peekToken().line;
     consume(VTokenType::Module);
     
@@ -688,12 +738,12 @@ std::unique_ptr<ASTNode> Parser::parseModuleStatement() {
     uint32_t mId = StringPool::instance().intern(nameToken.name);
     consumeSemicolon();
     
-    auto node = std::make_unique<ModuleNode>(mId, nameToken.name);
+    auto node = arena->make<ModuleNode>(mId, std::string(nameToken.name));
     node->lineNumber = line;
     return node;
 }
 
-std::unique_ptr<ASTNode> Parser::parseDismissStatement() {
+ASTNode* Parser::parseDismissStatement() {
     int line = peekToken().line;
     consume(VTokenType::Dismiss);
     
@@ -701,7 +751,7 @@ std::unique_ptr<ASTNode> Parser::parseDismissStatement() {
     uint32_t mId = StringPool::instance().intern(nameToken.name);
     consumeSemicolon();
     
-    auto node = std::make_unique<DismissNode>(mId, nameToken.name);
+    auto node = arena->make<DismissNode>(mId, std::string(nameToken.name));
     node->lineNumber = line;
     return node;
 }
\ No newline at end of file
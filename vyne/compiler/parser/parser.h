@@ -17,9 +17,19 @@ struct SymbolInfo {
 
 class Parser {
 private:
-	std::vector<Token> tokens;
-	size_t pos = 0;
+	// tokens are pulled from the lexer on demand into a ring that grows to the
+	// deepest lookAhead() seen, so the whole token list never exists at once
+	Lexer lexer;
+	std::vector<Token> ring = std::vector<Token>(8);
+	size_t head = 0;          // ring index of peekToken()
+	size_t buffered = 0;      // tokens in the ring from head on
+	bool drained = false;     // the lexer has handed out its End token
+	bool fill(size_t distance);
+	static const Token END;   // handed out once the source is used up
+	// every node of this parse is allocated here, the program root keeps it alive
+	std::shared_ptr<AstArena> arena = std::make_shared<AstArena>();
 	std::vector<std::unordered_map<uint32_t, SymbolInfo>> scopeStack;
+	std::vector<std::string> importPaths;   // every `use` path, in source order
 
 	void pushScope() { scopeStack.push_back({}); }
 	void popScope()  { scopeStack.pop_back(); }
@@ -48,50 +58,53 @@ private:
 	}
 
 	// --- Literal Workers ---
-	std::unique_ptr<ASTNode> parseStringLiteral();
-    std::unique_ptr<ASTNode> parseNumberLiteral();
-    std::unique_ptr<ASTNode> parseBooleanLiteral();
-    std::unique_ptr<ASTNode> parseArrayLiteral();
-    std::unique_ptr<ASTNode> parseGroupingExpr();
-    std::unique_ptr<ASTNode> parseIdentifierExpr();
+	ASTNode* parseStringLiteral();
+    ASTNode* parseNumberLiteral();
+    ASTNode* parseBooleanLiteral();
+    ASTNode* parseArrayLiteral();
+    ASTNode* parseMapLiteral();
+    ASTNode* parseGroupingExpr();
+    ASTNode* parseIdentifierExpr();
 
 	// --- Statement Workers ---
-	std::unique_ptr<ASTNode> parseBlock();
-	std::unique_ptr<ASTNode> parseReturnStatement();
-	std::unique_ptr<ASTNode> parseIfStatement();
-	std::unique_ptr<ASTNode> parseWhileLoop();
-	std::unique_ptr<ASTNode> parseForLoop();
-	std::unique_ptr<ASTNode> parseAssignment();
-	std::unique_ptr<ASTNode> parseGroupDefinition();
-	std::unique_ptr<ASTNode> parseModuleStatement();
-	std::unique_ptr<ASTNode> parseDismissStatement();
-	std::unique_ptr<ASTNode> parseLoopControl();
-	std::unique_ptr<ASTNode> parseStatement();
+	ASTNode* parseBlock();
+	ASTNode* parseReturnStatement();
+	ASTNode* parseIfStatement();
+	ASTNode* parseWhileLoop();
+	ASTNode* parseForLoop();
+	ASTNode* parseAssignment();
+	ASTNode* parseGroupDefinition();
+	ASTNode* parseModuleStatement();
+	ASTNode* parseDismissStatement();
+	ASTNode* parseLoopControl();
+	ASTNode* parseStatement();
+	/// `memo` is only special right before `sub`, it stays a usable name elsewhere.
+	bool atMemoSub();
 
 public:
 	// --- Navigation ---
-    Token peekToken();
-	Token getNextToken();
-    Token lookAhead(int distance);
-    Token consume(VTokenType expected);
-    void  consumeSemicolon();
+	// The returned tokens live in the lookahead ring: copy one that has to
+	// survive further navigation.
+	const Token& peekToken() { return (buffered || fill(0)) ? ring[head] : END; }
+	const Token& getNextToken();
+	const Token& lookAhead(int distance);
+	const Token& consume(VTokenType expected);
+	void         consumeSemicolon();
 
-	Parser(std::vector<Token>&& t) : tokens(std::move(t)) {};
+	explicit Parser(const std::string& source) : lexer(source) {};
+	Parser(std::string&&) = delete;   // tokens view into the source
 
-	std::unique_ptr<ASTNode>     parseFunctionDefinition();
-	std::unique_ptr<ASTNode>     parseBuiltInCall();
-	std::unique_ptr<ASTNode>     parseFactor();
-	std::unique_ptr<ASTNode>     parseTerm();
-	std::unique_ptr<ASTNode>     parsePostfix();
-	std::unique_ptr<ASTNode>     parseUnary();
-	std::unique_ptr<ASTNode>     parseAdditive();
-	std::unique_ptr<ASTNode>     parseRelational();
-	std::unique_ptr<ASTNode>     parseEquality();
-	std::unique_ptr<ASTNode>     parseLogicalAnd();
-	std::unique_ptr<ASTNode>     parseLogicalOr();
-	std::unique_ptr<ASTNode>     parseRange();
-	std::unique_ptr<ASTNode>     parseExpression();
-	std::unique_ptr<ASTNode>     parseImportModule();
-	std::unique_ptr<ASTNode>     parseDeployModule();
-	std::unique_ptr<ProgramNode> parseProgram();
+	ASTNode*                     parseFunctionDefinition();
+	ASTNode*                     parseBuiltInCall();
+	ASTNode*                     parseFactor();
+	ASTNode*                     parsePostfix();
+	ASTNode*                     parseUnary();
+	/// Binary operators by binding power (Pratt): only those binding tighter than minPower are taken.
+	ASTNode*                     parseExpression(int minPower = 0);
+	ASTNode*                     parseImportModule();
+	ASTNode*                     parseDeployModule();
+	std::shared_ptr<ProgramNode> parseProgram();
+
+	/// Files named by the `use` statements parsed so far.
+	const std::vector<std::string>& imports() const { return importPaths; }
 };
\ No newline at end of file
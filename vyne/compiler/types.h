@@ -2,12 +2,14 @@
 #include <string_view>
 #include <string>
 
-enum class VType { Unknown, Number, String, Array, Function, Module };
+enum class VType { Unknown, Number, String, Array, Function, Module, Map, Matrix };
 
 inline VType stringToVType(std::string_view name) {
     if (name == "Array")  return VType::Array;
     if (name == "Number") return VType::Number;
     if (name == "String") return VType::String;
+    if (name == "Map")    return VType::Map;
+    if (name == "Matrix") return VType::Matrix;
     return VType::Unknown;
 }
 
@@ -18,6 +20,8 @@ inline std::string VTypeToString(VType type) {
         case VType::Number:  return "Number";
         case VType::Function:return "Function";
         case VType::Module:  return "Module";
+        case VType::Map:     return "Map";
+        case VType::Matrix:  return "Matrix";
         default:             return "Unknown";
     }
 }
\ No newline at end of file
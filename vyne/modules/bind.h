@@ -0,0 +1,102 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "registry.h"
+
+/**
+ * @brief Native wrappers generated from a C++ function's signature.
+ * * @details bind<&f>("name") gives the NativeFunction table entry for a plain
+ * function like `double hypot(double, double)`. Its arity is the number of
+ * parameters, checked by the caller before the call like any table arity.
+ * The generated wrapper checks each argument's type, unboxes it straight
+ * out of the Value, calls f directly and boxes what it returns. It is an
+ * ordinary NativeFn: no std::function, no argument vector.
+ * * Supported parameter types are double, const std::string& and const
+ * Value& (anything goes). Returns can be double, bool, any other arithmetic
+ * type, std::string or Value.
+ */
+namespace NativeBinding {
+    template <typename T>
+    struct Arg {
+        static_assert(sizeof(T) == 0, "bind<>: unsupported parameter type, use double, const std::string& or const Value&");
+    };
+
+    template <>
+    struct Arg<double> {
+        static constexpr const char* name = "Number";
+        static bool accepts(const Value& v) { return v.getType() == Value::NUMBER; }
+        static double get(const Value& v) { return std::get<double>(v.data); }
+    };
+
+    template <>
+    struct Arg<const std::string&> {
+        static constexpr const char* name = "String";
+        static bool accepts(const Value& v) { return v.getType() == Value::STRING; }
+        static const std::string& get(const Value& v) { return v.asString(); }
+    };
+
+    template <>
+    struct Arg<const Value&> {
+        static constexpr const char* name = "Value";
+        static bool accepts(const Value&) { return true; }
+        static const Value& get(const Value& v) { return v; }
+    };
+
+    template <typename R>
+    Value box(R&& result) {
+        using T = std::decay_t<R>;
+        if constexpr (std::is_same_v<T, Value>) {
+            return std::forward<R>(result);
+        } else if constexpr (std::is_arithmetic_v<T>) {
+            return Value(static_cast<double>(result));
+        } else {
+            static_assert(std::is_same_v<T, std::string>, "bind<>: unsupported return type");
+            return Value(std::forward<R>(result));
+        }
+    }
+
+    [[noreturn]] inline void typeError(const NativeContext& ctx, size_t index, const char* expected, const Value& got) {
+        throw std::runtime_error("Argument Error: " + std::string(ctx.module) + "." + std::string(ctx.function)
+            + "() expects a " + expected + " as argument " + std::to_string(index + 1)
+            + ", but got " + got.getTypeName() + " [ line " + std::to_string(ctx.line) + " ]");
+    }
+
+    template <auto F>
+    struct Binder;
+
+    template <typename R, typename... A, R (*F)(A...)>
+    struct Binder<F> {
+        static constexpr int arity = sizeof...(A);
+
+        static Value call(const Value* args, size_t, NativeContext& ctx) {
+            return invoke(args, ctx, std::index_sequence_for<A...>{});
+        }
+
+    private:
+        template <size_t... I>
+        static Value invoke(const Value* args, NativeContext& ctx, std::index_sequence<I...>) {
+            (check<A>(args, I, ctx), ...);
+            if constexpr (std::is_void_v<R>) {
+                F(Arg<A>::get(args[I])...);
+                return Value();
+            } else {
+                return box(F(Arg<A>::get(args[I])...));
+            }
+        }
+
+        template <typename T>
+        static void check(const Value* args, size_t index, const NativeContext& ctx) {
+            if (!Arg<T>::accepts(args[index])) typeError(ctx, index, Arg<T>::name, args[index]);
+        }
+    };
+}
+
+/// Table entry for a plain C++ function, see NativeBinding.
+template <auto F>
+constexpr NativeFunction bind(std::string_view name) {
+    return {name, &NativeBinding::Binder<F>::call, NativeBinding::Binder<F>::arity};
+}
@@ -0,0 +1,64 @@
+#include "registry.h"
+#include "vcore/vcore.h"
+#include "vglib/vglib.h"
+#include "vmem/vmem.h"
+#include "vmath/vmath.h"
+
+#include <mutex>
+#include <utility>
+
+namespace {
+    const NativeModule* const MODULES[] = {&VCORE_MODULE, &VGLIB_MODULE, &VMEM_MODULE, &VMATH_MODULE};
+    constexpr size_t MODULE_COUNT = sizeof(MODULES) / sizeof(MODULES[0]);
+
+    struct Materialized {
+        std::once_flag once;
+        uint32_t nameId = 0;
+        std::vector<std::pair<uint32_t, Value>> exports;
+    };
+
+    Materialized& materialize(const NativeModule& module) {
+        static Materialized slots[MODULE_COUNT];
+
+        size_t index = 0;
+        while (MODULES[index] != &module) index++;
+        Materialized& slot = slots[index];
+
+        std::call_once(slot.once, [&] {
+            StringPool& pool = StringPool::instance();
+            slot.nameId = pool.intern(module.name);
+            slot.exports.reserve(module.functionCount + module.constantCount);
+
+            for (size_t i = 0; i < module.functionCount; ++i) {
+                const NativeFunction& entry = module.functions[i];
+                Value fn(entry.fn);
+                fn.asFunction()->arity = entry.arity;
+                slot.exports.emplace_back(pool.intern(entry.name), std::move(fn));
+            }
+
+            for (size_t i = 0; i < module.constantCount; ++i) {
+                const NativeConstant& entry = module.constants[i];
+                Value value = entry.text ? Value(entry.text) : Value(entry.number);
+                slot.exports.emplace_back(pool.intern(entry.name), std::move(value.setReadOnly()));
+            }
+        });
+        return slot;
+    }
+}
+
+const NativeModule* NativeRegistry::find(std::string_view name) {
+    for (const NativeModule* module : MODULES) {
+        if (module->name == name) return module;
+    }
+    return nullptr;
+}
+
+void NativeRegistry::load(const NativeModule& module, SymbolContainer& env) {
+    const Materialized& slot = materialize(module);
+    SymbolTable& exports = env[env.child(SymbolContainer::GLOBAL, slot.nameId)];
+
+    for (const auto& [id, value] : slot.exports) {
+        exports[id] = value;
+    }
+    if (module.bind) module.bind(env, exports);
+}
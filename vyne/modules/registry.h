@@ -0,0 +1,93 @@
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "../compiler/ast/ast.h"
+#include "../compiler/ast/value.h"
+
+/**
+ * @brief What a native function sees of its call besides the arguments.
+ */
+struct NativeContext {
+    SymbolContainer& env;          // environment the call runs in
+    const FunctionData& callee;    // the function being called, holds a lambda's captures
+    int line;                      // line of the call, for error messages
+    std::string_view module;       // names as written at the call, for error messages
+    std::string_view function;
+};
+
+/**
+ * @brief Wraps a callable as a native function Value.
+ * @details Takes anything callable as Value(const Value*, size_t, NativeContext&).
+ * A lambda without captures becomes a plain NativeFn; the captures of any
+ * other callable are kept in FunctionData::nativeState and found again
+ * through ctx.callee, so the call itself stays a plain function pointer call.
+ */
+template <typename F>
+Value makeNative(F fn) {
+    if constexpr (std::is_convertible_v<F, NativeFn>) {
+        return Value(static_cast<NativeFn>(fn));
+    } else {
+        auto func = std::make_shared<FunctionData>();
+        func->nativeState = std::make_shared<F>(std::move(fn));
+        func->nativeFn = [](const Value* args, size_t argc, NativeContext& ctx) -> Value {
+            return (*static_cast<F*>(ctx.callee.nativeState.get()))(args, argc, ctx);
+        };
+        func->isNative = true;
+        return Value(std::move(func));
+    }
+}
+
+/// Arity of a native that checks its argument count itself (optional or variadic arguments).
+constexpr int VARIADIC = -1;
+
+struct NativeFunction {
+    std::string_view name;
+    NativeFn fn;
+    int arity;   // checked before the call, unless VARIADIC
+};
+
+/**
+ * @brief A read-only property with a value known at compile time.
+ * @details A number, or a string when text is set.
+ */
+struct NativeConstant {
+    std::string_view name;
+    double number = 0.0;
+    const char* text = nullptr;
+};
+
+/**
+ * @brief Static description of a native module, one per module in its own .cpp.
+ * @details The tables are constexpr arrays; nothing is interned or allocated
+ * until the module is first referenced by a `module` statement. bind, when
+ * set, runs on every `module` statement for what a table can't hold, like
+ * properties read at that moment or lambdas registered with makeNative.
+ */
+struct NativeModule {
+    std::string_view name;
+    const NativeFunction* functions;
+    size_t functionCount;
+    const NativeConstant* constants;
+    size_t constantCount;
+    void (*bind)(SymbolContainer& env, SymbolTable& exports);
+};
+
+/**
+ * @brief Registry of the native modules compiled into the interpreter.
+ */
+namespace NativeRegistry {
+    /// The module called name, nullptr if there is none (a user module).
+    const NativeModule* find(std::string_view name);
+
+    /**
+     * @brief Puts the module's exports under its name below global in env.
+     * @details The first call for a module interns its names and creates its
+     * Values, once per process; later calls only copy those Values.
+     */
+    void load(const NativeModule& module, SymbolContainer& env);
+}
@@ -39,7 +39,7 @@ double getPhysicalMemoryUsage() {
  */
 namespace VCoreNative {
 
-    Value now(std::vector<Value>& args) {
+    Value now(const Value*, size_t, NativeContext&) {
         const std::time_t t = std::time(nullptr);
         std::tm tm{};
         #ifdef _WIN32
@@ -52,14 +52,14 @@ namespace VCoreNative {
         return Value(oss.str());
     }
 
-    Value sleep(std::vector<Value>& args) {
-        if (args.empty()) throw std::runtime_error("vcore.sleep() expects 1 argument (ms)");
+    Value sleep(const Value* args, size_t argc, NativeContext&) {
+        if (argc == 0) throw std::runtime_error("vcore.sleep() expects 1 argument (ms)");
         long long ms = static_cast<long long>(args[0].asNumber());
         std::this_thread::sleep_for(std::chrono::milliseconds(ms));
         return Value(true);
     }
 
-    Value platform(std::vector<Value>& args) {
+    Value platform(const Value*, size_t, NativeContext&) {
         #if defined(_WIN64)
             #if defined(_M_ARM64)
                 return Value("Windows ARM64");
@@ -81,8 +81,8 @@ namespace VCoreNative {
         #endif
     }
 
-    Value random(std::vector<Value>& args) {
-        if (args.size() < 2) throw std::runtime_error("Argument Error : vcore.random() expects 2 arguments (min, max)");
+    Value random(const Value* args, size_t argc, NativeContext&) {
+        if (argc < 2) throw std::runtime_error("Argument Error : vcore.random() expects 2 arguments (min, max)");
         static std::random_device rd;
         static std::mt19937 gen(rd());
         std::uniform_int_distribution<int> dist(
@@ -105,8 +105,8 @@ namespace VCoreNative {
      * ignored and no prompt is displayed.
      */
 
-    Value input(std::vector<Value>& args){
-        if(!args.empty() && args[0].getType() == Value::STRING){
+    Value input(const Value* args, size_t argc, NativeContext&){
+        if(argc > 0 && args[0].getType() == Value::STRING){
             std::cout << args[0].asString();
         }
 
@@ -123,56 +123,56 @@ namespace VCoreNative {
      * * This native function takes three arguments: the value to clamp, the lower bound,
      * and the upper bound. If the value is less than the minimum, the minimum is returned.
      * If the value is greater than the maximum, the maximum is returned.
-     * * @param args A vector containing:
-     * - args[0]: The input value (Number)
-     * - args[1]: The lower bound (Number)
-     * - args[2]: The upper bound (Number)
-     * * @throw std::runtime_error If the number of arguments is not exactly 3.
-     * @return Value The clamped numeric result.
+     * * @param val The input value
+     * @param min The lower bound
+     * @param max The upper bound
+     * @return The clamped numeric result.
      */
 
-    Value clamp(std::vector<Value>& args) {
-        if (args.size() != 3) {
-            throw std::runtime_error("Argument Error: vcore.clamp() expects 3 arguments (val, min, max), but got " + std::to_string(args.size()) + ".");
-        }
-
-        double val = args[0].asNumber();
-        double min = args[1].asNumber();
-        double max = args[2].asNumber();
-
+    double clamp(double val, double min, double max) {
         if (min > max) std::swap(min, max);
 
-        if (val < min) return Value(min);
-        if (val > max) return Value(max);
+        if (val < min) return min;
+        if (val > max) return max;
         
-        return Value(val);
+        return val;
     }
 }
 
-void setupVCore(SymbolContainer& env, StringPool& pool) {
-    std::string path = "global.vcore";
-    
-    if (env.find(path) == env.end()) {
-        env[path] = SymbolTable();
+namespace {
+    constexpr NativeFunction FUNCTIONS[] = {
+        {"now",      VCoreNative::now,      VARIADIC},
+        {"sleep",    VCoreNative::sleep,    VARIADIC},
+        {"platform", VCoreNative::platform, VARIADIC},
+        {"random",   VCoreNative::random,   VARIADIC},
+        {"input",    VCoreNative::input,    VARIADIC},
+        bind<&VCoreNative::clamp>("clamp"),
+    };
+
+    constexpr NativeConstant CONSTANTS[] = {
+        {"version", 0.0, "v0.0.1-alpha"},
+        {"engine",  0.0, "Vyne Native"},
+        {"build",   0.0, __DATE__ " " __TIME__},
+    };
+
+    /// Properties of the running process, read again on every `module vcore;`.
+    void bind(SymbolContainer&, SymbolTable& vcore) {
+        StringPool& pool = StringPool::instance();
+        static const uint32_t cwd = pool.intern("cwd");
+        static const uint32_t processorCount = pool.intern("processor_count");
+        static const uint32_t pid = pool.intern("pid");
+        static const uint32_t memoryUsage = pool.intern("memory_usage");
+
+        vcore[cwd]            = Value(std::filesystem::current_path().string()).setReadOnly();
+        vcore[processorCount] = Value(std::thread::hardware_concurrency());
+        vcore[pid]            = Value(static_cast<double>(getpid()));
+        vcore[memoryUsage]    = Value(getPhysicalMemoryUsage()).setReadOnly();
     }
+}
 
-    auto& vcore = env[path];
-
-
-    // VCore methods
-    vcore[pool.intern("now")]             = Value(VCoreNative::now);
-    vcore[pool.intern("sleep")]           = Value(VCoreNative::sleep);
-    vcore[pool.intern("platform")]        = Value(VCoreNative::platform);
-    vcore[pool.intern("random")]          = Value(VCoreNative::random);
-    vcore[pool.intern("input")]           = Value(VCoreNative::input);
-    vcore[pool.intern("clamp")]           = Value(VCoreNative::clamp);
-
-    // VCore properties
-    vcore[pool.intern("version")]         = Value("v0.0.1-alpha").setReadOnly();
-    vcore[pool.intern("engine")]          = Value("Vyne Native").setReadOnly();
-    vcore[pool.intern("build")]           = Value(std::string(__DATE__) + " " + std::string(__TIME__)).setReadOnly();
-    vcore[pool.intern("cwd")]             = Value(std::filesystem::current_path().string()).setReadOnly();
-    vcore[pool.intern("processor_count")] = Value(std::thread::hardware_concurrency());
-    vcore[pool.intern("pid")]             = Value(static_cast<double>(getpid()));
-    vcore[pool.intern("memory_usage")]    = Value(getPhysicalMemoryUsage()).setReadOnly();
-}
\ No newline at end of file
+const NativeModule VCORE_MODULE = {
+    "vcore",
+    FUNCTIONS, std::size(FUNCTIONS),
+    CONSTANTS, std::size(CONSTANTS),
+    bind,
+};
@@ -20,5 +20,7 @@
 
 #include "../../compiler/ast/ast.h"
 #include "../../compiler/ast/value.h"
+#include "../registry.h"
+#include "../bind.h"
 
-void setupVCore(SymbolContainer& env, StringPool& pool);
\ No newline at end of file
+extern const NativeModule VCORE_MODULE;
\ No newline at end of file
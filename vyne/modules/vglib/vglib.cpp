@@ -5,8 +5,8 @@
  */
 
 namespace VGLibNative {
-    Value native_donut(std::vector<Value>& args) {
-        if (args.size() < 2) throw std::runtime_error("donut() requires A and B arguments");
+    Value native_donut(const Value* args, size_t argc, NativeContext&) {
+        if (argc < 2) throw std::runtime_error("donut() requires A and B arguments");
 
         std::printf("\x1b[H\x1b[?25l\x1b[J");
 
@@ -56,18 +56,19 @@ namespace VGLibNative {
     }
 }
 
-void setupVGLib(SymbolContainer& env, StringPool& pool) {
-    std::string path = "global.vglib";
-    
-    if (env.find(path) == env.end()) {
-        env[path] = SymbolTable();
-    }
-
-    auto& vglib = env[path];
+namespace {
+    constexpr NativeFunction FUNCTIONS[] = {
+        {"donut", VGLibNative::native_donut, VARIADIC},
+    };
 
-    // VGLib methods
-    vglib[pool.intern("donut")]    = Value(VGLibNative::native_donut);
+    constexpr NativeConstant CONSTANTS[] = {
+        {"version", 0.0, "v0.0.1-alpha"},
+    };
+}
 
-    // VGLib properties
-    vglib[pool.intern("version")]  = Value("v0.0.1-alpha").setReadOnly();
-}
\ No newline at end of file
+const NativeModule VGLIB_MODULE = {
+    "vglib",
+    FUNCTIONS, std::size(FUNCTIONS),
+    CONSTANTS, std::size(CONSTANTS),
+    nullptr,
+};
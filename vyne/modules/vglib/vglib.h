@@ -9,5 +9,6 @@
 
 #include "../../compiler/ast/ast.h"
 #include "../../compiler/ast/value.h"
+#include "../registry.h"
 
-void setupVGLib(SymbolContainer& env, StringPool& pool);
\ No newline at end of file
+extern const NativeModule VGLIB_MODULE;
\ No newline at end of file
@@ -0,0 +1,318 @@
+#include "kernels.h"
+
+#include <cmath>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define VYNE_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+    // --- scalar: the reference, and the tail of every vector loop ---
+
+    void addScalar(const double* a, const double* b, double* out, size_t n) {
+        for (size_t i = 0; i < n; ++i) out[i] = a[i] + b[i];
+    }
+
+    void subScalar(const double* a, const double* b, double* out, size_t n) {
+        for (size_t i = 0; i < n; ++i) out[i] = a[i] - b[i];
+    }
+
+    void mulScalar(const double* a, const double* b, double* out, size_t n) {
+        for (size_t i = 0; i < n; ++i) out[i] = a[i] * b[i];
+    }
+
+    void scaleScalar(const double* a, double k, double* out, size_t n) {
+        for (size_t i = 0; i < n; ++i) out[i] = a[i] * k;
+    }
+
+    void sqrtScalar(const double* a, double* out, size_t n) {
+        for (size_t i = 0; i < n; ++i) out[i] = std::sqrt(a[i]);
+    }
+
+    void absScalar(const double* a, double* out, size_t n) {
+        for (size_t i = 0; i < n; ++i) out[i] = std::fabs(a[i]);
+    }
+
+    double sumScalar(const double* a, size_t n) {
+        double total = 0.0;
+        for (size_t i = 0; i < n; ++i) total += a[i];
+        return total;
+    }
+
+    double minScalar(const double* a, size_t n) {
+        double best = a[0];
+        for (size_t i = 1; i < n; ++i) best = a[i] < best ? a[i] : best;
+        return best;
+    }
+
+    double maxScalar(const double* a, size_t n) {
+        double best = a[0];
+        for (size_t i = 1; i < n; ++i) best = a[i] > best ? a[i] : best;
+        return best;
+    }
+
+    double dotScalar(const double* a, const double* b, size_t n) {
+        double total = 0.0;
+        for (size_t i = 0; i < n; ++i) total += a[i] * b[i];
+        return total;
+    }
+
+    // a holds 4 rows per step and b 4 columns per step, c is row-major with stride ldc
+    void tileScalar(const double* a, const double* b, double* c, size_t ldc, size_t k) {
+        double acc[4][4] = {};
+        for (size_t p = 0; p < k; ++p, a += 4, b += 4) {
+            for (size_t i = 0; i < 4; ++i) {
+                for (size_t j = 0; j < 4; ++j) acc[i][j] += a[i] * b[j];
+            }
+        }
+        for (size_t i = 0; i < 4; ++i) {
+            for (size_t j = 0; j < 4; ++j) c[i * ldc + j] += acc[i][j];
+        }
+    }
+
+    const VectorKernels SCALAR{"scalar", addScalar, subScalar, mulScalar, scaleScalar, sqrtScalar, absScalar,
+                               sumScalar, minScalar, maxScalar, dotScalar, tileScalar};
+
+#ifdef VYNE_KERNELS_X86
+    // --- SSE2: 2 doubles per step, always there on x86-64 ---
+
+    template <typename Op>
+    inline void binarySse2(const double* a, const double* b, double* out, size_t n, Op op) {
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2) {
+            _mm_storeu_pd(out + i, op(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+        }
+        for (; i < n; ++i) {
+            _mm_store_sd(out + i, op(_mm_load_sd(a + i), _mm_load_sd(b + i)));
+        }
+    }
+
+    template <typename Op>
+    inline void unarySse2(const double* a, double* out, size_t n, Op op) {
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2) _mm_storeu_pd(out + i, op(_mm_loadu_pd(a + i)));
+        for (; i < n; ++i) _mm_store_sd(out + i, op(_mm_load_sd(a + i)));
+    }
+
+    struct AddSse2  { __m128d operator()(__m128d x, __m128d y) const { return _mm_add_pd(x, y); } };
+    struct SubSse2  { __m128d operator()(__m128d x, __m128d y) const { return _mm_sub_pd(x, y); } };
+    struct MulSse2  { __m128d operator()(__m128d x, __m128d y) const { return _mm_mul_pd(x, y); } };
+    struct SqrtSse2 { __m128d operator()(__m128d x) const { return _mm_sqrt_pd(x); } };
+    struct AbsSse2  { __m128d operator()(__m128d x) const { return _mm_andnot_pd(_mm_set1_pd(-0.0), x); } };
+    struct ScaleSse2 {
+        __m128d factor;
+        __m128d operator()(__m128d x) const { return _mm_mul_pd(x, factor); }
+    };
+
+    void addSse2(const double* a, const double* b, double* out, size_t n)   { binarySse2(a, b, out, n, AddSse2{}); }
+    void subSse2(const double* a, const double* b, double* out, size_t n)   { binarySse2(a, b, out, n, SubSse2{}); }
+    void mulSse2(const double* a, const double* b, double* out, size_t n)   { binarySse2(a, b, out, n, MulSse2{}); }
+    void scaleSse2(const double* a, double k, double* out, size_t n)        { unarySse2(a, out, n, ScaleSse2{_mm_set1_pd(k)}); }
+    void sqrtSse2(const double* a, double* out, size_t n)                   { unarySse2(a, out, n, SqrtSse2{}); }
+    void absSse2(const double* a, double* out, size_t n)                    { unarySse2(a, out, n, AbsSse2{}); }
+
+    inline double horizontal(__m128d v) {
+        return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v)));
+    }
+
+    double sumSse2(const double* a, size_t n) {
+        __m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd();
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            s0 = _mm_add_pd(s0, _mm_loadu_pd(a + i));
+            s1 = _mm_add_pd(s1, _mm_loadu_pd(a + i + 2));
+        }
+        return horizontal(_mm_add_pd(s0, s1)) + sumScalar(a + i, n - i);
+    }
+
+    double minSse2(const double* a, size_t n) {
+        if (n < 2) return minScalar(a, n);
+        __m128d best = _mm_loadu_pd(a);
+        size_t i = 2;
+        for (; i + 2 <= n; i += 2) best = _mm_min_pd(best, _mm_loadu_pd(a + i));
+        double lanes[2];
+        _mm_storeu_pd(lanes, best);
+        double result = lanes[0] < lanes[1] ? lanes[0] : lanes[1];
+        return i < n ? std::fmin(result, minScalar(a + i, n - i)) : result;
+    }
+
+    double maxSse2(const double* a, size_t n) {
+        if (n < 2) return maxScalar(a, n);
+        __m128d best = _mm_loadu_pd(a);
+        size_t i = 2;
+        for (; i + 2 <= n; i += 2) best = _mm_max_pd(best, _mm_loadu_pd(a + i));
+        double lanes[2];
+        _mm_storeu_pd(lanes, best);
+        double result = lanes[0] > lanes[1] ? lanes[0] : lanes[1];
+        return i < n ? std::fmax(result, maxScalar(a + i, n - i)) : result;
+    }
+
+    double dotSse2(const double* a, const double* b, size_t n) {
+        __m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd();
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            s0 = _mm_add_pd(s0, _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+            s1 = _mm_add_pd(s1, _mm_mul_pd(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2)));
+        }
+        return horizontal(_mm_add_pd(s0, s1)) + dotScalar(a + i, b + i, n - i);
+    }
+
+    // each row of the tile is two registers, eight accumulators in all
+    void tileSse2(const double* a, const double* b, double* c, size_t ldc, size_t k) {
+        __m128d acc[4][2];
+        for (auto& row : acc) row[0] = row[1] = _mm_setzero_pd();
+
+        for (size_t p = 0; p < k; ++p, a += 4, b += 4) {
+            __m128d b0 = _mm_loadu_pd(b), b1 = _mm_loadu_pd(b + 2);
+            for (size_t i = 0; i < 4; ++i) {
+                __m128d ai = _mm_set1_pd(a[i]);
+                acc[i][0] = _mm_add_pd(acc[i][0], _mm_mul_pd(ai, b0));
+                acc[i][1] = _mm_add_pd(acc[i][1], _mm_mul_pd(ai, b1));
+            }
+        }
+        for (size_t i = 0; i < 4; ++i) {
+            double* row = c + i * ldc;
+            _mm_storeu_pd(row, _mm_add_pd(_mm_loadu_pd(row), acc[i][0]));
+            _mm_storeu_pd(row + 2, _mm_add_pd(_mm_loadu_pd(row + 2), acc[i][1]));
+        }
+    }
+
+    const VectorKernels SSE2{"sse2", addSse2, subSse2, mulSse2, scaleSse2, sqrtSse2, absSse2,
+                             sumSse2, minSse2, maxSse2, dotSse2, tileSse2};
+
+    // --- AVX2: 4 doubles per step, only used when the CPU reports it ---
+
+#define VYNE_AVX2 __attribute__((target("avx2")))
+
+    template <typename Op>
+    VYNE_AVX2 inline void binaryAvx2(const double* a, const double* b, double* out, size_t n, Op op) {
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            _mm256_storeu_pd(out + i, op(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+        }
+        for (; i < n; ++i) {
+            __m256d x = _mm256_castpd128_pd256(_mm_load_sd(a + i));
+            __m256d y = _mm256_castpd128_pd256(_mm_load_sd(b + i));
+            _mm_store_sd(out + i, _mm256_castpd256_pd128(op(x, y)));
+        }
+    }
+
+    template <typename Op>
+    VYNE_AVX2 inline void unaryAvx2(const double* a, double* out, size_t n, Op op) {
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) _mm256_storeu_pd(out + i, op(_mm256_loadu_pd(a + i)));
+        for (; i < n; ++i) {
+            _mm_store_sd(out + i, _mm256_castpd256_pd128(op(_mm256_castpd128_pd256(_mm_load_sd(a + i)))));
+        }
+    }
+
+    // operations are structs rather than lambdas: a lambda's function pointer
+    // thunk would be compiled without AVX and pass __m256d through memory
+    struct AddAvx2  { VYNE_AVX2 __m256d operator()(__m256d x, __m256d y) const { return _mm256_add_pd(x, y); } };
+    struct SubAvx2  { VYNE_AVX2 __m256d operator()(__m256d x, __m256d y) const { return _mm256_sub_pd(x, y); } };
+    struct MulAvx2  { VYNE_AVX2 __m256d operator()(__m256d x, __m256d y) const { return _mm256_mul_pd(x, y); } };
+    struct SqrtAvx2 { VYNE_AVX2 __m256d operator()(__m256d x) const { return _mm256_sqrt_pd(x); } };
+    struct AbsAvx2  { VYNE_AVX2 __m256d operator()(__m256d x) const { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), x); } };
+    struct ScaleAvx2 {
+        double factor;
+        VYNE_AVX2 __m256d operator()(__m256d x) const { return _mm256_mul_pd(x, _mm256_set1_pd(factor)); }
+    };
+
+    VYNE_AVX2 void addAvx2(const double* a, const double* b, double* out, size_t n)   { binaryAvx2(a, b, out, n, AddAvx2{}); }
+    VYNE_AVX2 void subAvx2(const double* a, const double* b, double* out, size_t n)   { binaryAvx2(a, b, out, n, SubAvx2{}); }
+    VYNE_AVX2 void mulAvx2(const double* a, const double* b, double* out, size_t n)   { binaryAvx2(a, b, out, n, MulAvx2{}); }
+    VYNE_AVX2 void scaleAvx2(const double* a, double k, double* out, size_t n)        { unaryAvx2(a, out, n, ScaleAvx2{k}); }
+    VYNE_AVX2 void sqrtAvx2(const double* a, double* out, size_t n)                   { unaryAvx2(a, out, n, SqrtAvx2{}); }
+    VYNE_AVX2 void absAvx2(const double* a, double* out, size_t n)                    { unaryAvx2(a, out, n, AbsAvx2{}); }
+
+    VYNE_AVX2 inline double horizontal(__m256d v) {
+        __m128d pair = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+        return horizontal(pair);
+    }
+
+    VYNE_AVX2 double sumAvx2(const double* a, size_t n) {
+        __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            s0 = _mm256_add_pd(s0, _mm256_loadu_pd(a + i));
+            s1 = _mm256_add_pd(s1, _mm256_loadu_pd(a + i + 4));
+        }
+        return horizontal(_mm256_add_pd(s0, s1)) + sumSse2(a + i, n - i);
+    }
+
+    VYNE_AVX2 double minAvx2(const double* a, size_t n) {
+        if (n < 4) return minSse2(a, n);
+        __m256d best = _mm256_loadu_pd(a);
+        size_t i = 4;
+        for (; i + 4 <= n; i += 4) best = _mm256_min_pd(best, _mm256_loadu_pd(a + i));
+        double lanes[4];
+        _mm256_storeu_pd(lanes, best);
+        double result = minScalar(lanes, 4);
+        return i < n ? std::fmin(result, minScalar(a + i, n - i)) : result;
+    }
+
+    VYNE_AVX2 double maxAvx2(const double* a, size_t n) {
+        if (n < 4) return maxSse2(a, n);
+        __m256d best = _mm256_loadu_pd(a);
+        size_t i = 4;
+        for (; i + 4 <= n; i += 4) best = _mm256_max_pd(best, _mm256_loadu_pd(a + i));
+        double lanes[4];
+        _mm256_storeu_pd(lanes, best);
+        double result = maxScalar(lanes, 4);
+        return i < n ? std::fmax(result, maxScalar(a + i, n - i)) : result;
+    }
+
+    VYNE_AVX2 double dotAvx2(const double* a, const double* b, size_t n) {
+        __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            s0 = _mm256_add_pd(s0, _mm256_mul_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+            s1 = _mm256_add_pd(s1, _mm256_mul_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4)));
+        }
+        return horizontal(_mm256_add_pd(s0, s1)) + dotSse2(a + i, b + i, n - i);
+    }
+
+    // one register per row of the tile
+    VYNE_AVX2 void tileAvx2(const double* a, const double* b, double* c, size_t ldc, size_t k) {
+        __m256d c0 = _mm256_setzero_pd(), c1 = _mm256_setzero_pd();
+        __m256d c2 = _mm256_setzero_pd(), c3 = _mm256_setzero_pd();
+
+        for (size_t p = 0; p < k; ++p, a += 4, b += 4) {
+            __m256d row = _mm256_loadu_pd(b);
+            c0 = _mm256_add_pd(c0, _mm256_mul_pd(_mm256_set1_pd(a[0]), row));
+            c1 = _mm256_add_pd(c1, _mm256_mul_pd(_mm256_set1_pd(a[1]), row));
+            c2 = _mm256_add_pd(c2, _mm256_mul_pd(_mm256_set1_pd(a[2]), row));
+            c3 = _mm256_add_pd(c3, _mm256_mul_pd(_mm256_set1_pd(a[3]), row));
+        }
+        _mm256_storeu_pd(c,           _mm256_add_pd(_mm256_loadu_pd(c),           c0));
+        _mm256_storeu_pd(c + ldc,     _mm256_add_pd(_mm256_loadu_pd(c + ldc),     c1));
+        _mm256_storeu_pd(c + 2 * ldc, _mm256_add_pd(_mm256_loadu_pd(c + 2 * ldc), c2));
+        _mm256_storeu_pd(c + 3 * ldc, _mm256_add_pd(_mm256_loadu_pd(c + 3 * ldc), c3));
+    }
+
+#undef VYNE_AVX2
+
+    const VectorKernels AVX2{"avx2", addAvx2, subAvx2, mulAvx2, scaleAvx2, sqrtAvx2, absAvx2,
+                             sumAvx2, minAvx2, maxAvx2, dotAvx2, tileAvx2};
+
+    bool hasAvx2() {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+    }
+#endif
+}
+
+const VectorKernels& activeKernels() {
+    static const VectorKernels* active = availableKernels().back();
+    return *active;
+}
+
+std::vector<const VectorKernels*> availableKernels() {
+    std::vector<const VectorKernels*> kernels{&SCALAR};
+#ifdef VYNE_KERNELS_X86
+    kernels.push_back(&SSE2);
+    if (hasAvx2()) kernels.push_back(&AVX2);
+#endif
+    return kernels;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief vmath's array loops over packed doubles, as one table of function pointers.
+ * @details Elementwise routines write n results to out, which may be one of
+ * the inputs. min and max need n > 0. Reductions keep several partial sums
+ * or extremes side by side, so a sum can differ from a left-to-right one in
+ * the last bits; with NaNs in the input, min and max are unspecified.
+ * tile adds up its k products in order for every cell, with no fused
+ * multiply-add, so all implementations give the same bits.
+ * * The best implementation the CPU supports (AVX2, SSE2, then plain scalar
+ * code) is picked once, the first time a kernel is needed.
+ */
+struct VectorKernels {
+    const char* name;
+
+    void (*add)(const double* a, const double* b, double* out, size_t n);
+    void (*sub)(const double* a, const double* b, double* out, size_t n);
+    void (*mul)(const double* a, const double* b, double* out, size_t n);
+    void (*scale)(const double* a, double k, double* out, size_t n);
+    void (*sqrt)(const double* a, double* out, size_t n);
+    void (*abs)(const double* a, double* out, size_t n);
+
+    double (*sum)(const double* a, size_t n);
+    double (*min)(const double* a, size_t n);
+    double (*max)(const double* a, size_t n);
+    double (*dot)(const double* a, const double* b, size_t n);
+
+    /// c += a * b for one 4x4 block of a matrix product, see matrix.h for the packing.
+    void (*tile)(const double* a, const double* b, double* c, size_t ldc, size_t k);
+};
+
+/// The kernels vmath uses.
+const VectorKernels& activeKernels();
+
+/// Every kernel set this CPU can run, slowest first.
+std::vector<const VectorKernels*> availableKernels();
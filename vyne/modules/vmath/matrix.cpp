@@ -0,0 +1,141 @@
+#include "matrix.h"
+#include "kernels.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+namespace {
+    constexpr size_t TILE = 4;     // rows and columns of one tile kernel call
+    constexpr size_t MC   = 64;    // rows of a per packed block
+    constexpr size_t KC   = 256;   // depth of a packed block, MC x KC doubles sit in L2
+    constexpr size_t NC   = 1024;  // columns of b per packed slice
+
+    size_t roundUp(size_t n) { return (n + TILE - 1) / TILE * TILE; }
+
+    /// rows x depth of a as panels of TILE rows: element (i, p) of a panel at [p * TILE + i].
+    void packRows(const double* a, size_t lda, size_t rows, size_t depth, double* panel) {
+        for (size_t i0 = 0; i0 < rows; i0 += TILE, panel += depth * TILE) {
+            size_t height = std::min(TILE, rows - i0);
+            for (size_t p = 0; p < depth; ++p) {
+                for (size_t i = 0; i < TILE; ++i) {
+                    panel[p * TILE + i] = i < height ? a[(i0 + i) * lda + p] : 0.0;
+                }
+            }
+        }
+    }
+
+    /// depth x cols of b as panels of TILE columns: element (p, j) of a panel at [p * TILE + j].
+    void packCols(const double* b, size_t ldb, size_t depth, size_t cols, double* panel) {
+        for (size_t j0 = 0; j0 < cols; j0 += TILE, panel += depth * TILE) {
+            size_t width = std::min(TILE, cols - j0);
+            for (size_t p = 0; p < depth; ++p) {
+                const double* row = b + p * ldb + j0;
+                for (size_t j = 0; j < TILE; ++j) panel[p * TILE + j] = j < width ? row[j] : 0.0;
+            }
+        }
+    }
+}
+
+void MatrixKernels::multiply(const double* a, const double* b, double* out, size_t m, size_t k, size_t n) {
+    std::fill(out, out + m * n, 0.0);
+    if (m == 0 || n == 0 || k == 0) return;
+
+    const auto tile = activeKernels().tile;
+    std::vector<double> packedA(roundUp(std::min(m, MC)) * std::min(k, KC));
+    std::vector<double> packedB(roundUp(std::min(n, NC)) * std::min(k, KC));
+
+    for (size_t jc = 0; jc < n; jc += NC) {
+        size_t nc = std::min(NC, n - jc);
+
+        for (size_t pc = 0; pc < k; pc += KC) {
+            size_t kc = std::min(KC, k - pc);
+            packCols(b + pc * n + jc, n, kc, nc, packedB.data());
+
+            for (size_t ic = 0; ic < m; ic += MC) {
+                size_t mc = std::min(MC, m - ic);
+                packRows(a + ic * k + pc, k, mc, kc, packedA.data());
+
+                for (size_t j0 = 0; j0 < nc; j0 += TILE) {
+                    const double* panelB = packedB.data() + j0 * kc;
+                    size_t width = std::min(TILE, nc - j0);
+
+                    for (size_t i0 = 0; i0 < mc; i0 += TILE) {
+                        const double* panelA = packedA.data() + i0 * kc;
+                        double* c = out + (ic + i0) * n + jc + j0;
+                        size_t height = std::min(TILE, mc - i0);
+
+                        if (height == TILE && width == TILE) {
+                            tile(panelA, panelB, c, n, kc);
+                            continue;
+                        }
+
+                        // edge tile: run it on a full 4x4 scratch and keep the part inside out
+                        double edge[TILE * TILE] = {};
+                        tile(panelA, panelB, edge, TILE, kc);
+                        for (size_t i = 0; i < height; ++i) {
+                            for (size_t j = 0; j < width; ++j) c[i * n + j] += edge[i * TILE + j];
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void MatrixKernels::transpose(const double* a, double* out, size_t rows, size_t cols) {
+    constexpr size_t BLOCK = 32;
+
+    for (size_t r0 = 0; r0 < rows; r0 += BLOCK) {
+        size_t r1 = std::min(rows, r0 + BLOCK);
+        for (size_t c0 = 0; c0 < cols; c0 += BLOCK) {
+            size_t c1 = std::min(cols, c0 + BLOCK);
+            for (size_t r = r0; r < r1; ++r) {
+                for (size_t c = c0; c < c1; ++c) out[c * rows + r] = a[r * cols + c];
+            }
+        }
+    }
+}
+
+bool MatrixKernels::solve(double* a, double* b, size_t n, size_t rhs) {
+    double largest = 0.0;
+    for (size_t i = 0; i < n * n; ++i) largest = std::max(largest, std::fabs(a[i]));
+    const double tolerance = largest * static_cast<double>(n) * DBL_EPSILON;
+
+    for (size_t col = 0; col < n; ++col) {
+        size_t pivot = col;
+        for (size_t r = col + 1; r < n; ++r) {
+            if (std::fabs(a[r * n + col]) > std::fabs(a[pivot * n + col])) pivot = r;
+        }
+        if (!(std::fabs(a[pivot * n + col]) > tolerance)) return false;
+
+        if (pivot != col) {
+            std::swap_ranges(a + pivot * n, a + pivot * n + n, a + col * n);
+            std::swap_ranges(b + pivot * rhs, b + pivot * rhs + rhs, b + col * rhs);
+        }
+
+        const double* pivotRow = a + col * n;
+        const double* pivotRhs = b + col * rhs;
+        for (size_t r = col + 1; r < n; ++r) {
+            double* row = a + r * n;
+            double factor = row[col] / pivotRow[col];
+            if (factor == 0.0) continue;
+
+            row[col] = 0.0;
+            for (size_t c = col + 1; c < n; ++c) row[c] -= factor * pivotRow[c];
+            for (size_t c = 0; c < rhs; ++c) b[r * rhs + c] -= factor * pivotRhs[c];
+        }
+    }
+
+    for (size_t row = n; row-- > 0;) {
+        const double* coeffs = a + row * n;
+        double* x = b + row * rhs;
+        for (size_t below = row + 1; below < n; ++below) {
+            const double* known = b + below * rhs;
+            for (size_t c = 0; c < rhs; ++c) x[c] -= coeffs[below] * known[c];
+        }
+        for (size_t c = 0; c < rhs; ++c) x[c] /= coeffs[row];
+    }
+    return true;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+
+/**
+ * @brief Dense matrix routines behind vmath's Matrix functions.
+ * @details Every matrix is row-major with no padding between rows, as in
+ * MatrixData. Outputs must not overlap the inputs.
+ */
+namespace MatrixKernels {
+    /**
+     * @brief out (m x n) = a (m x k) * b (k x n).
+     * @details Blocked so a slice of b stays in cache while every row block of
+     * a runs over it. Both slices are first copied into panels four rows or
+     * four columns wide, in the order the 4x4 tile kernel (VectorKernels::tile)
+     * reads them, so its inner loop only walks forward through memory.
+     */
+    void multiply(const double* a, const double* b, double* out, size_t m, size_t k, size_t n);
+
+    /// out (cols x rows) = the transpose of a (rows x cols), in cache-sized blocks.
+    void transpose(const double* a, double* out, size_t rows, size_t cols);
+
+    /**
+     * @brief Solves a x = b by Gaussian elimination with partial pivoting.
+     * @details a is n x n and b n x rhs; both are overwritten, b with x.
+     * Returns false, leaving both half-eliminated, when a is singular (a pivot
+     * is zero relative to a's largest entry).
+     */
+    bool solve(double* a, double* b, size_t n, size_t rhs);
+}
@@ -2,492 +2,461 @@
 
 /**
  * VMathNative Native Method Implementations
+ * Plain double kernels, bind<> generates the argument checks and boxing.
  */
 
 namespace VMathNative {
-    Value clamp(std::vector<Value>& args) {
-        if (args.size() != 3) {
-            throw std::runtime_error("Argument Error: vmath.clamp() expects 3 arguments (val, min, max), but got " + std::to_string(args.size()) + ".");
-        }
-
-        double val = args[0].asNumber();
-        double min = args[1].asNumber();
-        double max = args[2].asNumber();
-
+    double clamp(double val, double min, double max) {
         if (min > max) std::swap(min, max);
 
-        if (val < min) return Value(min);
-        if (val > max) return Value(max);
-        
-        return Value(val);
-    }
-
-    Value sqrt(std::vector<Value>& args) {
-        if (args.size() != 1) {
-            throw std::runtime_error("Argument Error: vmath.sqrt() expects 1 argument, but got " + std::to_string(args.size()) + ".");
-        }
-
-        if (args[0].getType() != Value::NUMBER) {
-            throw std::runtime_error("Argument Error: vmath.sqrt() excepts only Number type as argument, but got " + args[0].getTypeName());
-        }
+        if (val < min) return min;
+        if (val > max) return max;
 
-        double val = args[0].asNumber();
+        return val;
+    }
 
+    double sqrt(double val) {
         if (val < 0) {
             throw std::runtime_error("Runtime Error: Square root of negative number is not supported in vmath.sqrt().");
         }
-
-        double returnVal = std::sqrt(val);
-
-        return Value(returnVal);
+        return std::sqrt(val);
     }
 
-    Value abs(std::vector<Value>& args) {
-        if (args.size() != 1) {
-            throw std::runtime_error("Argument Error: vmath.abs() expects 1 argument, but got " + std::to_string(args.size()) + ".");
-        }
+    double abs(double val)     { return std::abs(val); }
+    double sinh(double val)    { return std::sinh(val); }
+    double cosh(double val)    { return std::cosh(val); }
+    double tanh(double val)    { return std::tanh(val); }
+    double degrees(double val) { return val * 180.0 / 3.141592653589793; }
+    double radians(double val) { return val * 3.141592653589793 / 180.0; }
 
-        if (args[0].getType() != Value::NUMBER) {
-            throw std::runtime_error("Argument Error: vmath.abs() expects only Number type as argument, but got " + args[0].getTypeName());
+    double fmod(double a, double b) {
+        if (b == 0) {
+            throw std::runtime_error("Runtime Error: Division by zero in fmod.");
         }
-
-        double val = args[0].asNumber();
-        
-        double returnVal = std::abs(val);
-
-        return Value(returnVal);
+        return std::fmod(a, b);
     }
 
-    Value sinh(std::vector<Value>& args) {
-        if (args.size() != 1) {
-            throw std::runtime_error("Argument Error: vmath.sinh() expects 1 argument, but got " + std::to_string(args.size()) + ".");
-        }
-
-        if (args[0].getType() != Value::NUMBER) {
-            throw std::runtime_error("Argument Error: vmath.sinh() expects only Number type as argument, but got " + args[0].getTypeName());
-        }
+    double hypot(double a, double b) { return std::hypot(a, b); }
 
-        double val = args[0].asNumber();
-        return Value(std::sinh(val));
-    }
+    // My trigonometry is so ahh lmao
+    double sin(double val) { return std::sin(val); }
+    double cos(double val) { return std::cos(val); }
+    double tan(double val) { return std::tan(val); }
 
-    Value cosh(std::vector<Value>& args) {
-        if (args.size() != 1) {
-            throw std::runtime_error("Argument Error: vmath.cosh() expects 1 argument, but got " + std::to_string(args.size()) + ".");
+    double asin(double val) {
+        if (val < -1.0 || val > 1.0) {
+            throw std::runtime_error("Runtime Error: asin argument must be between -1 and 1.");
         }
+        return std::asin(val);
+    }
 
-        if (args[0].getType() != Value::NUMBER) {
-            throw std::runtime_error("Argument Error: vmath.cosh() expects only Number type as argument, but got " + args[0].getTypeName());
+    double acos(double val) {
+        if (val < -1.0 || val > 1.0) { // I'm suprised that this even works
+            throw std::runtime_error("Runtime Error: acos argument must be between -1 and 1.");
         }
-
-        double val = args[0].asNumber();
-        return Value(std::cosh(val));
+        return std::acos(val);
     }
 
-    Value tanh(std::vector<Value>& args) {
-        if (args.size() != 1) {
-            throw std::runtime_error("Argument Error: vmath.tanh() expects 1 argument, but got " + std::to_string(args.size()) + ".");
-        }
+    double atan(double val)           { return std::atan(val); }
+    double atan2(double y, double x)  { return std::atan2(y, x); }
 
-        if (args[0].getType() != Value::NUMBER) {
-            throw std::runtime_error("Argument Error: vmath.tanh() expects only Number type as argument, but got " + args[0].getTypeName());
+    double log(double val) {
+        if (val <= 0) {
+            throw std::runtime_error("Runtime Error: log argument must be positive.");
         }
-
-        double val = args[0].asNumber();
-        return Value(std::tanh(val));
+        return std::log(val); // The GOAT
     }
 
-    Value degrees(std::vector<Value>& args) {
-        if (args.size() != 1) {
-            throw std::runtime_error("Argument Error: vmath.degrees() expects 1 argument, but got " + std::to_string(args.size()) + ".");
-        }
-
-        if (args[0].getType() != Value::NUMBER) {
-            throw std::runtime_error("Argument Error: vmath.degrees() expects only Number type as argument, but got " + args[0].getTypeName());
+    double log10(double val) {
+        if (val <= 0) {
+            throw std::runtime_error("Runtime Error: log10 argument must be positive.");
         }
-
-        double val = args[0].asNumber();
-        return Value(val * 180.0 / 3.141592653589793);
+        return std::log10(val);
     }
 
-    Value radians(std::vector<Value>& args) {
-        if (args.size() != 1) {
-            throw std::runtime_error("Argument Error: vmath.radians() expects 1 argument, but got " + std::to_string(args.size()) + ".");
-        }
+    double exp(double val)                   { return std::exp(val); }
+    double pow(double base, double exponent) { return std::pow(base, exponent); }
+    double floor(double val)                 { return std::floor(val); }
+    double ceil(double val)                  { return std::ceil(val); }
+    double round(double val)                 { return std::round(val); }
+
+    // Some boring stuff
+    double min(double a, double b)  { return a < b ? a : b; }
+    double max(double a, double b)  { return a > b ? a : b; }
+    double erf(double val)          { return std::erf(val); }
+    double erfc(double val)         { return std::erfc(val); }
+    double tgamma(double val)       { return std::tgamma(val); }
+    double lgamma(double val)       { return std::lgamma(val); }
+}
 
-        if (args[0].getType() != Value::NUMBER) {
-            throw std::runtime_error("Argument Error: vmath.radians() expects only Number type as argument, but got " + args[0].getTypeName());
-        }
+/**
+ * Whole-array entry points: one native call per array instead of one per
+ * element, running the SIMD loops in kernels.cpp over packed storage.
+ */
 
-        double val = args[0].asNumber();
-        return Value(val * 3.141592653589793 / 180.0);
+namespace VMathArrays {
+    std::string where(const NativeContext& ctx) {
+        return "vmath." + std::string(ctx.function) + "() [ line " + std::to_string(ctx.line) + " ]";
     }
 
-    Value fmod(std::vector<Value>& args) {
-        if (args.size() != 2) {
-            throw std::runtime_error("Argument Error: vmath.fmod() expects 2 arguments, but got " + std::to_string(args.size()) + ".");
-        }
+    /// The numbers of an array argument: its packed storage, or a copy in scratch if it isn't packed.
+    const std::vector<double>& numbers(const Value* args, size_t index, NativeContext& ctx, std::vector<double>& scratch) {
+        const Value& arg = args[index];
+        if (arg.getType() != Value::ARRAY) NativeBinding::typeError(ctx, index, "Array", arg);
 
-        if (args[0].getType() != Value::NUMBER || args[1].getType() != Value::NUMBER) {
-            throw std::runtime_error("Argument Error: vmath.fmod() expects only Number types as arguments.");
-        }
+        const ArrayData& arr = arg.asArray();
+        if (arr.isPacked()) return arr.packedData();
 
-        double a = args[0].asNumber();
-        double b = args[1].asNumber();
-        if (b == 0) {
-            throw std::runtime_error("Runtime Error: Division by zero in fmod.");
+        scratch.clear();
+        scratch.reserve(arr.size());
+        for (const Value& item : arr.genericData()) {
+            if (item.getType() != Value::NUMBER) {
+                throw std::runtime_error("Argument Error: vmath." + std::string(ctx.function) + "() expects an Array of Numbers as argument "
+                    + std::to_string(index + 1) + ", but it holds a " + item.getTypeName() + " [ line " + std::to_string(ctx.line) + " ]");
+            }
+            scratch.push_back(item.asNumber());
         }
-        return Value(std::fmod(a, b));
+        return scratch;
     }
 
-    Value hypot(std::vector<Value>& args) {
-        if (args.size() != 2) {
-            throw std::runtime_error("Argument Error: vmath.hypot() expects 2 arguments, but got " + std::to_string(args.size()) + ".");
-        }
-
-        if (args[0].getType() != Value::NUMBER || args[1].getType() != Value::NUMBER) {
-            throw std::runtime_error("Argument Error: vmath.hypot() expects only Number types as arguments.");
-        }
-
-        double a = args[0].asNumber();
-        double b = args[1].asNumber();
-        return Value(std::hypot(a, b));
+    Value packed(std::vector<double> values) {
+        return Value(std::make_shared<ArrayData>(std::move(values)));
     }
 
-    Value sin(std::vector<Value>& args) {
-        if (args.size() != 1) {
-            throw std::runtime_error("Argument Error: vmath.sin() expects 1 argument, but got " + std::to_string(args.size()) + ".");
-        } // My trigonometry is so ahh lmao
-
-        if (args[0].getType() != Value::NUMBER) {
-            throw std::runtime_error("Argument Error: vmath.sin() expects only Number type as argument, but got " + args[0].getTypeName());
+    void sameLength(const std::vector<double>& a, const std::vector<double>& b, const NativeContext& ctx) {
+        if (a.size() != b.size()) {
+            throw std::runtime_error("Runtime Error: arrays of length " + std::to_string(a.size()) + " and "
+                + std::to_string(b.size()) + " passed to " + where(ctx));
         }
-
-        double val = args[0].asNumber();
-        return Value(std::sin(val));
     }
 
-    Value cos(std::vector<Value>& args) {
-        if (args.size() != 1) {
-            throw std::runtime_error("Argument Error: vmath.cos() expects 1 argument, but got " + std::to_string(args.size()) + ".");
-        }
-
-        if (args[0].getType() != Value::NUMBER) {
-            throw std::runtime_error("Argument Error: vmath.cos() expects only Number type as argument, but got " + args[0].getTypeName());
-        }
+    template <double (*F)(double)>
+    Value mapEach(const Value* args, size_t, NativeContext& ctx) {
+        std::vector<double> scratch;
+        const std::vector<double>& in = numbers(args, 0, ctx, scratch);
 
-        double val = args[0].asNumber();
-        return Value(std::cos(val));
+        std::vector<double> out(in.size());
+        for (size_t i = 0; i < in.size(); ++i) out[i] = F(in[i]);
+        return packed(std::move(out));
     }
 
-    Value tan(std::vector<Value>& args) {
-        if (args.size() != 1) {
-            throw std::runtime_error("Argument Error: vmath.tan() expects 1 argument, but got " + std::to_string(args.size()) + ".");
-        }
-
-        if (args[0].getType() != Value::NUMBER) {
-            throw std::runtime_error("Argument Error: vmath.tan() expects only Number type as argument, but got " + args[0].getTypeName());
-        }
+    template <void (*VectorKernels::*Kernel)(const double*, double*, size_t)>
+    Value mapKernel(const Value* args, size_t, NativeContext& ctx) {
+        std::vector<double> scratch;
+        const std::vector<double>& in = numbers(args, 0, ctx, scratch);
 
-        double val = args[0].asNumber();
-        return Value(std::tan(val));
+        std::vector<double> out(in.size());
+        (activeKernels().*Kernel)(in.data(), out.data(), in.size());
+        return packed(std::move(out));
     }
 
-    Value asin(std::vector<Value>& args) {
-        if (args.size() != 1) {
-            throw std::runtime_error("Argument Error: vmath.asin() expects 1 argument, but got " + std::to_string(args.size()) + ".");
-        }
-
-        if (args[0].getType() != Value::NUMBER) {
-            throw std::runtime_error("Argument Error: vmath.asin() expects only Number type as argument, but got " + args[0].getTypeName());
-        }
-
-        double val = args[0].asNumber();
-        if (val < -1.0 || val > 1.0) {
-            throw std::runtime_error("Runtime Error: asin argument must be between -1 and 1.");
-        }
-        return Value(std::asin(val));
+    const MatrixData& matrix(const Value* args, size_t index, const NativeContext& ctx) {
+        if (args[index].getType() != Value::MATRIX) NativeBinding::typeError(ctx, index, "Matrix", args[index]);
+        return args[index].asMatrix();
     }
 
-    Value acos(std::vector<Value>& args) {
-        if (args.size() != 1) {
-            throw std::runtime_error("Argument Error: vmath.acos() expects 1 argument, but got " + std::to_string(args.size()) + ".");
-        }
-
-        if (args[0].getType() != Value::NUMBER) {
-            throw std::runtime_error("Argument Error: vmath.acos() expects only Number type as argument, but got " + args[0].getTypeName());
-        }
-
-        double val = args[0].asNumber();
-        if (val < -1.0 || val > 1.0) { // I'm suprised that this even works
-            throw std::runtime_error("Runtime Error: acos argument must be between -1 and 1.");
-        }
-        return Value(std::acos(val));
+    std::string shapeOf(const MatrixData& m) {
+        return std::to_string(m.rows()) + "x" + std::to_string(m.cols());
     }
 
-    Value atan(std::vector<Value>& args) {
-        if (args.size() != 1) {
-            throw std::runtime_error("Argument Error: vmath.atan() expects 1 argument, but got " + std::to_string(args.size()) + ".");
-        }
-
-        if (args[0].getType() != Value::NUMBER) {
-            throw std::runtime_error("Argument Error: vmath.atan() expects only Number type as argument, but got " + args[0].getTypeName());
+    /// add, subtract and mul also take two matrices of the same shape, cell by cell.
+    template <void (*VectorKernels::*Kernel)(const double*, const double*, double*, size_t)>
+    Value zipMatrices(const Value* args, NativeContext& ctx) {
+        const MatrixData& a = matrix(args, 0, ctx);
+        const MatrixData& b = matrix(args, 1, ctx);
+        if (!a.sameShape(b)) {
+            throw std::runtime_error("Runtime Error: matrices of shape " + shapeOf(a) + " and " + shapeOf(b) + " passed to " + where(ctx));
         }
 
-        double val = args[0].asNumber();
-        return Value(std::atan(val));
+        auto out = std::make_shared<MatrixData>(a.rows(), a.cols());
+        (activeKernels().*Kernel)(a.data(), b.data(), out->data(), a.size());
+        return Value(std::move(out));
     }
 
-    Value atan2(std::vector<Value>& args) {
-        if (args.size() != 2) {
-            throw std::runtime_error("Argument Error: vmath.atan2() expects 2 arguments, but got " + std::to_string(args.size()) + ".");
-        }
+    template <void (*VectorKernels::*Kernel)(const double*, const double*, double*, size_t)>
+    Value zip(const Value* args, size_t, NativeContext& ctx) {
+        if (args[0].getType() == Value::MATRIX) return zipMatrices<Kernel>(args, ctx);
 
-        if (args[0].getType() != Value::NUMBER || args[1].getType() != Value::NUMBER) {
-            throw std::runtime_error("Argument Error: vmath.atan2() expects only Number types as arguments.");
-        }
+        std::vector<double> scratchA, scratchB;
+        const std::vector<double>& a = numbers(args, 0, ctx, scratchA);
+        const std::vector<double>& b = numbers(args, 1, ctx, scratchB);
+        sameLength(a, b, ctx);
 
-        double y = args[0].asNumber();
-        double x = args[1].asNumber();
-        return Value(std::atan2(y, x));
+        std::vector<double> out(a.size());
+        (activeKernels().*Kernel)(a.data(), b.data(), out.data(), a.size());
+        return packed(std::move(out));
     }
 
-    Value log(std::vector<Value>& args) {
-        if (args.size() != 1) {
-            throw std::runtime_error("Argument Error: vmath.log() expects 1 argument, but got " + std::to_string(args.size()) + ".");
-        }
-
-        if (args[0].getType() != Value::NUMBER) {
-            throw std::runtime_error("Argument Error: vmath.log() expects only Number type as argument, but got " + args[0].getTypeName());
+    Value mapSqrt(const Value* args, size_t, NativeContext& ctx) {
+        std::vector<double> scratch;
+        const std::vector<double>& in = numbers(args, 0, ctx, scratch);
+        if (!in.empty() && activeKernels().min(in.data(), in.size()) < 0) {
+            throw std::runtime_error("Runtime Error: Square root of negative number is not supported in vmath.map_sqrt().");
         }
 
-        double val = args[0].asNumber();
-        if (val <= 0) {
-            throw std::runtime_error("Runtime Error: log argument must be positive.");
-        }
-        return Value(std::log(val)); // The GOAT
+        std::vector<double> out(in.size());
+        activeKernels().sqrt(in.data(), out.data(), in.size());
+        return packed(std::move(out));
     }
 
-    Value log10(std::vector<Value>& args) {
-        if (args.size() != 1) {
-            throw std::runtime_error("Argument Error: vmath.log10() expects 1 argument, but got " + std::to_string(args.size()) + ".");
-        }
-
-        if (args[0].getType() != Value::NUMBER) {
-            throw std::runtime_error("Argument Error: vmath.log10() expects only Number type as argument, but got " + args[0].getTypeName());
+    Value mapLog(const Value* args, size_t, NativeContext& ctx) {
+        std::vector<double> scratch;
+        const std::vector<double>& in = numbers(args, 0, ctx, scratch);
+        if (!in.empty() && activeKernels().min(in.data(), in.size()) <= 0) {
+            throw std::runtime_error("Runtime Error: log argument must be positive.");
         }
 
-        double val = args[0].asNumber();
-        if (val <= 0) {
-            throw std::runtime_error("Runtime Error: log10 argument must be positive.");
-        }
-        return Value(std::log10(val));
+        std::vector<double> out(in.size());
+        for (size_t i = 0; i < in.size(); ++i) out[i] = std::log(in[i]);
+        return packed(std::move(out));
     }
 
-    Value exp(std::vector<Value>& args) {
-        if (args.size() != 1) {
-            throw std::runtime_error("Argument Error: vmath.exp() expects 1 argument, but got " + std::to_string(args.size()) + ".");
-        }
+    Value scale(const Value* args, size_t, NativeContext& ctx) {
+        if (args[1].getType() != Value::NUMBER) NativeBinding::typeError(ctx, 1, "Number", args[1]);
 
-        if (args[0].getType() != Value::NUMBER) {
-            throw std::runtime_error("Argument Error: vmath.exp() expects only Number type as argument, but got " + args[0].getTypeName());
+        if (args[0].getType() == Value::MATRIX) {
+            const MatrixData& m = args[0].asMatrix();
+            auto out = std::make_shared<MatrixData>(m.rows(), m.cols());
+            activeKernels().scale(m.data(), args[1].asNumber(), out->data(), m.size());
+            return Value(std::move(out));
         }
 
-        double val = args[0].asNumber();
-        return Value(std::exp(val));
-    }
+        std::vector<double> scratch;
+        const std::vector<double>& in = numbers(args, 0, ctx, scratch);
 
-    Value pow(std::vector<Value>& args) {
-        if (args.size() != 2) {
-            throw std::runtime_error("Argument Error: vmath.pow() expects 2 arguments, but got " + std::to_string(args.size()) + ".");
-        }
-
-        if (args[0].getType() != Value::NUMBER || args[1].getType() != Value::NUMBER) {
-            throw std::runtime_error("Argument Error: vmath.pow() expects only Number types as arguments.");
-        }
-
-        double base = args[0].asNumber();
-        double exponent = args[1].asNumber();
-        return Value(std::pow(base, exponent));
+        std::vector<double> out(in.size());
+        activeKernels().scale(in.data(), args[1].asNumber(), out.data(), in.size());
+        return packed(std::move(out));
     }
 
-    Value floor(std::vector<Value>& args) {
-        if (args.size() != 1) {
-            throw std::runtime_error("Argument Error: vmath.floor() expects 1 argument, but got " + std::to_string(args.size()) + ".");
-        }
-
-        if (args[0].getType() != Value::NUMBER) {
-            throw std::runtime_error("Argument Error: vmath.floor() expects only Number type as argument, but got " + args[0].getTypeName());
-        }
-
-        double val = args[0].asNumber();
-        return Value(std::floor(val));
+    Value sum(const Value* args, size_t, NativeContext& ctx) {
+        std::vector<double> scratch;
+        const std::vector<double>& in = numbers(args, 0, ctx, scratch);
+        return Value(activeKernels().sum(in.data(), in.size()));
     }
 
-    Value ceil(std::vector<Value>& args) {
-        if (args.size() != 1) {
-            throw std::runtime_error("Argument Error: vmath.ceil() expects 1 argument, but got " + std::to_string(args.size()) + ".");
-        }
-
-        if (args[0].getType() != Value::NUMBER) {
-            throw std::runtime_error("Argument Error: vmath.ceil() expects only Number type as argument, but got " + args[0].getTypeName());
-        }
-
-        double val = args[0].asNumber();
-        return Value(std::ceil(val));
+    Value dot(const Value* args, size_t, NativeContext& ctx) {
+        std::vector<double> scratchA, scratchB;
+        const std::vector<double>& a = numbers(args, 0, ctx, scratchA);
+        const std::vector<double>& b = numbers(args, 1, ctx, scratchB);
+        sameLength(a, b, ctx);
+        return Value(activeKernels().dot(a.data(), b.data(), a.size()));
     }
 
-    Value round(std::vector<Value>& args) {
-        if (args.size() != 1) {
-            throw std::runtime_error("Argument Error: vmath.round() expects 1 argument, but got " + std::to_string(args.size()) + ".");
+    /// min and max take two numbers, as before, or one array to reduce.
+    template <double (*Pair)(double, double), double (*VectorKernels::*Reduce)(const double*, size_t)>
+    Value extreme(const Value* args, size_t argc, NativeContext& ctx) {
+        if (argc == 1) {
+            std::vector<double> scratch;
+            const std::vector<double>& in = numbers(args, 0, ctx, scratch);
+            if (in.empty()) throw std::runtime_error("Runtime Error: empty array passed to " + where(ctx));
+            return Value((activeKernels().*Reduce)(in.data(), in.size()));
         }
 
-        if (args[0].getType() != Value::NUMBER) {
-            throw std::runtime_error("Argument Error: vmath.round() expects only Number type as argument, but got " + args[0].getTypeName());
+        if (argc != 2) {
+            throw std::runtime_error("Argument Error: vmath." + std::string(ctx.function) + "() expects 2 Numbers or 1 Array, but got "
+                + std::to_string(argc) + " arguments instead [ line " + std::to_string(ctx.line) + " ]");
         }
-
-        double val = args[0].asNumber();
-        return Value(std::round(val));
+        for (size_t i = 0; i < 2; ++i) {
+            if (args[i].getType() != Value::NUMBER) NativeBinding::typeError(ctx, i, "Number", args[i]);
+        }
+        return Value(Pair(args[0].asNumber(), args[1].asNumber()));
     }
+}
 
-    Value min(std::vector<Value>& args) {
-        if (args.size() != 2) {
-            throw std::runtime_error("Argument Error: vmath.min() expects 2 arguments, but got " + std::to_string(args.size()) + ".");
-        }
+/**
+ * Matrix entry points. A Matrix is built once from nested arrays (or by
+ * identity) and every operation returns a new one, see MatrixData.
+ */
 
-        if (args[0].getType() != Value::NUMBER || args[1].getType() != Value::NUMBER) {
-            throw std::runtime_error("Argument Error: vmath.min() expects only Number types as arguments.");
-        }
+namespace VMathMatrices {
+    using VMathArrays::where;
+    using VMathArrays::matrix;
+    using VMathArrays::shapeOf;
 
-        double a = args[0].asNumber();
-        double b = args[1].asNumber();
-        return Value(a < b ? a : b);
+    Value make(size_t rows, size_t cols, std::vector<double> cells) {
+        return Value(std::make_shared<MatrixData>(rows, cols, std::move(cells)));
     }
 
-    Value max(std::vector<Value>& args) {
-        if (args.size() != 2) {
-            throw std::runtime_error("Argument Error: vmath.max() expects 2 arguments, but got " + std::to_string(args.size()) + ".");
-        }
+    /// matrix(rows): an Array of rows, each an Array of Numbers, all of the same length.
+    Value fromArrays(const Value* args, size_t, NativeContext& ctx) {
+        if (args[0].getType() != Value::ARRAY) NativeBinding::typeError(ctx, 0, "Array", args[0]);
+        const ArrayData& rows = args[0].asArray();
+
+        std::vector<double> cells;
+        size_t cols = 0;
+        for (size_t r = 0; r < rows.size(); ++r) {
+            Value row = rows.at(r);
+            if (row.getType() != Value::ARRAY) {
+                throw std::runtime_error("Argument Error: vmath.matrix() expects an Array of rows, but row " + std::to_string(r + 1)
+                    + " is a " + row.getTypeName() + " [ line " + std::to_string(ctx.line) + " ]");
+            }
+
+            std::vector<double> scratch;
+            const std::vector<double>& values = VMathArrays::numbers(&row, 0, ctx, scratch);
+            if (r == 0) {
+                cols = values.size();
+                cells.reserve(rows.size() * cols);
+            } else if (values.size() != cols) {
+                throw std::runtime_error("Runtime Error: rows of length " + std::to_string(cols) + " and "
+                    + std::to_string(values.size()) + " passed to " + where(ctx));
+            }
+            cells.insert(cells.end(), values.begin(), values.end());
+        }
+        return make(rows.size(), cols, std::move(cells));
+    }
 
-        if (args[0].getType() != Value::NUMBER || args[1].getType() != Value::NUMBER) {
-            throw std::runtime_error("Argument Error: vmath.max() expects only Number types as arguments.");
+    Value identity(double n) {
+        if (n < 0 || n != std::floor(n)) {
+            throw std::runtime_error("Runtime Error: vmath.identity() needs a whole, non-negative size.");
         }
 
-        double a = args[0].asNumber();
-        double b = args[1].asNumber();
-        return Value(a > b ? a : b);
-    } // Some boring stuff
+        size_t size = static_cast<size_t>(n);
+        auto out = std::make_shared<MatrixData>(size, size);
+        for (size_t i = 0; i < size; ++i) out->data()[i * size + i] = 1.0;
+        return Value(std::move(out));
+    }
 
-    Value erf(std::vector<Value>& args) {
-        if (args.size() != 1) {
-            throw std::runtime_error("Argument Error: vmath.erf() expects 1 argument, but got " + std::to_string(args.size()) + ".");
-        }
+    Value toArrays(const Value* args, size_t, NativeContext& ctx) {
+        const MatrixData& m = matrix(args, 0, ctx);
 
-        if (args[0].getType() != Value::NUMBER) {
-            throw std::runtime_error("Argument Error: vmath.erf() expects only Number type as argument, but got " + args[0].getTypeName());
+        std::vector<Value> rows;
+        rows.reserve(m.rows());
+        for (size_t r = 0; r < m.rows(); ++r) {
+            const double* row = m.data() + r * m.cols();
+            rows.emplace_back(VMathArrays::packed(std::vector<double>(row, row + m.cols())));
         }
-
-        double val = args[0].asNumber();
-        return Value(std::erf(val));
+        return Value(std::move(rows));
     }
 
-    Value erfc(std::vector<Value>& args) {
-        if (args.size() != 1) {
-            throw std::runtime_error("Argument Error: vmath.erfc() expects 1 argument, but got " + std::to_string(args.size()) + ".");
-        }
+    Value shape(const Value* args, size_t, NativeContext& ctx) {
+        const MatrixData& m = matrix(args, 0, ctx);
+        return VMathArrays::packed({static_cast<double>(m.rows()), static_cast<double>(m.cols())});
+    }
 
-        if (args[0].getType() != Value::NUMBER) {
-            throw std::runtime_error("Argument Error: vmath.erfc() expects only Number type as argument, but got " + args[0].getTypeName());
+    Value multiply(const Value* args, size_t, NativeContext& ctx) {
+        const MatrixData& a = matrix(args, 0, ctx);
+        const MatrixData& b = matrix(args, 1, ctx);
+        if (a.cols() != b.rows()) {
+            throw std::runtime_error("Runtime Error: cannot multiply a " + shapeOf(a) + " matrix by a " + shapeOf(b) + " one in " + where(ctx));
         }
 
-        double val = args[0].asNumber();
-        return Value(std::erfc(val));
+        auto out = std::make_shared<MatrixData>(a.rows(), b.cols());
+        MatrixKernels::multiply(a.data(), b.data(), out->data(), a.rows(), a.cols(), b.cols());
+        return Value(std::move(out));
     }
 
-    Value tgamma(std::vector<Value>& args) {
-        if (args.size() != 1) {
-            throw std::runtime_error("Argument Error: vmath.tgamma() expects 1 argument, but got " + std::to_string(args.size()) + ".");
-        }
-
-        if (args[0].getType() != Value::NUMBER) {
-            throw std::runtime_error("Argument Error: vmath.tgamma() expects only Number type as argument, but got " + args[0].getTypeName());
-        }
+    Value transpose(const Value* args, size_t, NativeContext& ctx) {
+        const MatrixData& m = matrix(args, 0, ctx);
 
-        double val = args[0].asNumber();
-        return Value(std::tgamma(val));
+        auto out = std::make_shared<MatrixData>(m.cols(), m.rows());
+        MatrixKernels::transpose(m.data(), out->data(), m.rows(), m.cols());
+        return Value(std::move(out));
     }
 
-    Value lgamma(std::vector<Value>& args) {
-        if (args.size() != 1) {
-            throw std::runtime_error("Argument Error: vmath.lgamma() expects 1 argument, but got " + std::to_string(args.size()) + ".");
+    /// solve(A, b): x with A x = b. b is a Matrix with as many rows as A, or an Array for a single right-hand side.
+    Value solve(const Value* args, size_t, NativeContext& ctx) {
+        const MatrixData& a = matrix(args, 0, ctx);
+        if (a.rows() != a.cols()) {
+            throw std::runtime_error("Runtime Error: a square matrix is needed, but a " + shapeOf(a) + " one was passed to " + where(ctx));
         }
 
-        if (args[0].getType() != Value::NUMBER) {
-            throw std::runtime_error("Argument Error: vmath.lgamma() expects only Number type as argument, but got " + args[0].getTypeName());
+        bool single = args[1].getType() != Value::MATRIX;
+        std::vector<double> scratch;
+        const std::vector<double>& rhs = single ? VMathArrays::numbers(args, 1, ctx, scratch) : args[1].asMatrix().values();
+        size_t rhsCols = single ? 1 : args[1].asMatrix().cols();
+        if (rhs.size() != a.rows() * rhsCols) {
+            std::string got = single ? "an array of length " + std::to_string(rhs.size()) : "a " + shapeOf(args[1].asMatrix()) + " matrix";
+            throw std::runtime_error("Runtime Error: a " + shapeOf(a) + " matrix and " + got + " passed to " + where(ctx));
         }
 
-        double val = args[0].asNumber();
-        return Value(std::lgamma(val));
+        std::vector<double> coeffs = a.values();
+        std::vector<double> x = rhs;
+        if (!MatrixKernels::solve(coeffs.data(), x.data(), a.rows(), rhsCols)) {
+            throw std::runtime_error("Runtime Error: singular matrix passed to " + where(ctx));
+        }
+        return single ? VMathArrays::packed(std::move(x)) : make(a.rows(), rhsCols, std::move(x));
     }
 }
 
-void setupVMath(SymbolContainer& env, StringPool& pool) {
-    std::string path = "global.vmath";
-    
-    if (env.find(path) == env.end()) {
-        env[path] = SymbolTable();
-    }
+namespace {
+    constexpr NativeFunction FUNCTIONS[] = {
+        bind<&VMathNative::clamp>("clamp"),
+        bind<&VMathNative::sqrt>("sqrt"),
+        bind<&VMathNative::abs>("abs"),
+        bind<&VMathNative::sinh>("sinh"),
+        bind<&VMathNative::cosh>("cosh"),
+        bind<&VMathNative::tanh>("tanh"),
+        bind<&VMathNative::degrees>("degrees"),
+        bind<&VMathNative::radians>("radians"),
+        bind<&VMathNative::fmod>("fmod"),
+        bind<&VMathNative::hypot>("hypot"),
+        bind<&VMathNative::sin>("sin"),
+        bind<&VMathNative::cos>("cos"),
+        bind<&VMathNative::tan>("tan"),
+        bind<&VMathNative::asin>("asin"),
+        bind<&VMathNative::acos>("acos"),
+        bind<&VMathNative::atan>("atan"),
+        bind<&VMathNative::atan2>("atan2"),
+        bind<&VMathNative::log>("log"),
+        bind<&VMathNative::log10>("log10"),
+        bind<&VMathNative::exp>("exp"),
+        bind<&VMathNative::pow>("pow"),
+        bind<&VMathNative::floor>("floor"),
+        bind<&VMathNative::ceil>("ceil"),
+        bind<&VMathNative::round>("round"),
+        {"min",     VMathArrays::extreme<VMathNative::min, &VectorKernels::min>, VARIADIC},
+        {"max",     VMathArrays::extreme<VMathNative::max, &VectorKernels::max>, VARIADIC},
+        bind<&VMathNative::erf>("erf"),
+        bind<&VMathNative::erfc>("erfc"),
+        bind<&VMathNative::tgamma>("tgamma"),
+        bind<&VMathNative::lgamma>("lgamma"),
+
+        {"map_sin",  VMathArrays::mapEach<VMathNative::sin>,          1},
+        {"map_cos",  VMathArrays::mapEach<VMathNative::cos>,          1},
+        {"map_tan",  VMathArrays::mapEach<VMathNative::tan>,          1},
+        {"map_exp",  VMathArrays::mapEach<VMathNative::exp>,          1},
+        {"map_log",  VMathArrays::mapLog,                             1},
+        {"map_sqrt", VMathArrays::mapSqrt,                            1},
+        {"map_abs",  VMathArrays::mapKernel<&VectorKernels::abs>,     1},
+        {"add",      VMathArrays::zip<&VectorKernels::add>,           2},
+        {"subtract", VMathArrays::zip<&VectorKernels::sub>,           2},
+        {"mul",      VMathArrays::zip<&VectorKernels::mul>,           2},
+        {"scale",    VMathArrays::scale,                              2},
+        {"sum",      VMathArrays::sum,                                1},
+        {"dot",      VMathArrays::dot,                                2},
+
+        {"matrix",    VMathMatrices::fromArrays,                      1},
+        bind<&VMathMatrices::identity>("identity"),
+        {"to_array",  VMathMatrices::toArrays,                        1},
+        {"shape",     VMathMatrices::shape,                           1},
+        {"matmul",    VMathMatrices::multiply,                        2},
+        {"transpose", VMathMatrices::transpose,                       1},
+        {"solve",     VMathMatrices::solve,                           2},
+    };
+
+    constexpr NativeConstant CONSTANTS[] = {
+        {"pi",          3.141592653589793},
+        {"e",           2.718281828459045},
+        {"tau",         6.283185307179586},
+        {"phi",         1.618033988749895},
+        {"sqrt2",       1.414213562373095},
+        {"pi_half",     1.5707963267948966},
+        {"pi_quarter",  0.7853981633974483},
+        {"sqrt3",       1.732050807568877},
+        {"sqrt5",       2.23606797749979},
+        {"ln2",         0.6931471805599453},
+        {"ln10",        2.302585092994046},
+        {"euler_gamma", 0.5772156649015329},
+        {"inf",         INFINITY},
+        {"nan",         NAN},
+        {"version",     0.0, "v0.0.1-alpha"},
+    };
+}
 
-    auto& vmath = env[path];
-
-    // VMath methods
-    vmath[pool.intern("clamp")]    = Value(VMathNative::clamp);
-    vmath[pool.intern("sqrt")]     = Value(VMathNative::sqrt);
-    vmath[pool.intern("abs")]      = Value(VMathNative::abs);
-    vmath[pool.intern("sinh")]     = Value(VMathNative::sinh);
-    vmath[pool.intern("cosh")]     = Value(VMathNative::cosh);
-    vmath[pool.intern("tanh")]     = Value(VMathNative::tanh);
-    vmath[pool.intern("degrees")]  = Value(VMathNative::degrees);
-    vmath[pool.intern("radians")]  = Value(VMathNative::radians);
-    vmath[pool.intern("fmod")]     = Value(VMathNative::fmod);
-    vmath[pool.intern("hypot")]    = Value(VMathNative::hypot);
-    vmath[pool.intern("sin")]      = Value(VMathNative::sin);
-    vmath[pool.intern("cos")]      = Value(VMathNative::cos);
-    vmath[pool.intern("tan")]      = Value(VMathNative::tan);
-    vmath[pool.intern("asin")]     = Value(VMathNative::asin);
-    vmath[pool.intern("acos")]     = Value(VMathNative::acos);
-    vmath[pool.intern("atan")]     = Value(VMathNative::atan);
-    vmath[pool.intern("atan2")]    = Value(VMathNative::atan2);
-    vmath[pool.intern("log")]      = Value(VMathNative::log);
-    vmath[pool.intern("log10")]    = Value(VMathNative::log10);
-    vmath[pool.intern("exp")]      = Value(VMathNative::exp);
-    vmath[pool.intern("pow")]      = Value(VMathNative::pow);
-    vmath[pool.intern("floor")]    = Value(VMathNative::floor);
-    vmath[pool.intern("ceil")]     = Value(VMathNative::ceil);
-    vmath[pool.intern("round")]    = Value(VMathNative::round);
-    vmath[pool.intern("min")]      = Value(VMathNative::min);
-    vmath[pool.intern("max")]      = Value(VMathNative::max);
-    vmath[pool.intern("erf")]      = Value(VMathNative::erf);
-    vmath[pool.intern("erfc")]     = Value(VMathNative::erfc);
-    vmath[pool.intern("tgamma")]   = Value(VMathNative::tgamma);
-    vmath[pool.intern("lgamma")]   = Value(VMathNative::lgamma);
-
-    // VMath constants
-    vmath[pool.intern("pi")]       = Value(3.141592653589793).setReadOnly();
-    vmath[pool.intern("e")]        = Value(2.718281828459045).setReadOnly();
-    vmath[pool.intern("tau")]      = Value(6.283185307179586).setReadOnly();
-    vmath[pool.intern("phi")]      = Value(1.618033988749895).setReadOnly();
-    vmath[pool.intern("sqrt2")]    = Value(1.414213562373095).setReadOnly();
-    vmath[pool.intern("pi_half")]  = Value(1.5707963267948966).setReadOnly();
-    vmath[pool.intern("pi_quarter")] = Value(0.7853981633974483).setReadOnly();
-    vmath[pool.intern("sqrt3")]    = Value(1.732050807568877).setReadOnly();
-    vmath[pool.intern("sqrt5")]    = Value(2.23606797749979).setReadOnly();
-    vmath[pool.intern("ln2")]      = Value(0.6931471805599453).setReadOnly();
-    vmath[pool.intern("ln10")]     = Value(2.302585092994046).setReadOnly();
-    vmath[pool.intern("euler_gamma")] = Value(0.5772156649015329).setReadOnly();
-    vmath[pool.intern("inf")]      = Value(INFINITY).setReadOnly();
-    vmath[pool.intern("nan")]      = Value(NAN).setReadOnly();
-
-    // VMath properties
-    vmath[pool.intern("version")]  = Value("v0.0.1-alpha").setReadOnly();
-}
\ No newline at end of file
+const NativeModule VMATH_MODULE = {
+    "vmath",
+    FUNCTIONS, std::size(FUNCTIONS),
+    CONSTANTS, std::size(CONSTANTS),
+    nullptr,
+};
@@ -9,5 +9,9 @@
 
 #include "../../compiler/ast/ast.h"
 #include "../../compiler/ast/value.h"
+#include "../registry.h"
+#include "../bind.h"
+#include "kernels.h"
+#include "matrix.h"
 
-void setupVMath(SymbolContainer& env, StringPool& pool);
\ No newline at end of file
+extern const NativeModule VMATH_MODULE;
\ No newline at end of file
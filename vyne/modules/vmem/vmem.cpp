@@ -5,14 +5,8 @@
  */
 
 namespace VMemNative {
-    static SymbolContainer* g_env = nullptr;
-
-    void setEnv(SymbolContainer& env) {
-        g_env = &env;
-    }
-
-    Value address(std::vector<Value>& args) {
-        if (args.empty()) return Value("0x0");
+    Value address(const Value* args, size_t argc, NativeContext&) {
+        if (argc == 0) return Value("0x0");
 
         const Value& val = args[0];
         const void* actualPtr = nullptr;
@@ -22,10 +16,10 @@ namespace VMemNative {
                 actualPtr = &val.data; 
                 break;
             case Value::STRING:
-                actualPtr = std::get<std::shared_ptr<std::string>>(val.data).get();
+                actualPtr = val.asStringData().get();
                 break;
             case Value::ARRAY:
-                actualPtr = std::get<std::shared_ptr<std::vector<Value>>>(val.data).get();
+                actualPtr = std::get<std::shared_ptr<ArrayData>>(val.data).get();
                 break;
             case Value::FUNCTION:
                 actualPtr = val.asFunction().get();
@@ -39,44 +33,51 @@ namespace VMemNative {
         return Value(ss.str());
     }
 
-    Value usage(std::vector<Value>& args){
+    Value usage(const Value* args, size_t argc, NativeContext& ctx){
         size_t totalBytes = 0;
 
-        if(args.size() > 1) throw std::runtime_error("Argument Error : vmem.usage() takes 1 or 0 arguments, but got " + std::to_string(args.size()));
+        if(argc > 1) throw std::runtime_error("Argument Error : vmem.usage() takes 1 or 0 arguments, but got " + std::to_string(argc));
 
-        if (!g_env) return Value(0.0);
-
-        if(args.empty()){
-            for (auto const& [groupName, table] : *g_env) {
-                totalBytes += groupName.capacity();
+        if(argc == 0){
+            ctx.env.forEach([&totalBytes](ScopeId, const SymbolTable& table) {
+                totalBytes += sizeof(SymbolContainer::Scope);
 
                 for (auto const& [id, val] : table) {
                     totalBytes += sizeof(uint32_t); 
                     totalBytes += sizeof(Value);
                     totalBytes += val.getDeepBytes();
                 }
-            }
+            });
 
             return Value(static_cast<double>(totalBytes));
         } else {
             return Value(args[0].getDeepBytes());
         }
     }
-}
 
-void setupVMem(SymbolContainer& env, StringPool& pool) {
-    VMemNative::setEnv(env);
-    std::string path = "global.vmem";
-    
-    if (env.find(path) == env.end()) {
-        env[path] = SymbolTable();
-    }
+    Value memoStats() {
+        MemoStats stats = MemoCache::stats();
+        auto result = std::make_shared<MapData>();
 
-    auto& vmem = env[path];
+        result->set(Value("hits"),      Value(static_cast<double>(stats.hits)));
+        result->set(Value("misses"),    Value(static_cast<double>(stats.misses)));
+        result->set(Value("evictions"), Value(static_cast<double>(stats.evictions)));
 
-    // vmem methods
-    vmem[pool.intern("address")] = Value(VMemNative::address);
-    vmem[pool.intern("usage")]   = Value(VMemNative::usage);
+        return Value(result);
+    }
+}
+
+namespace {
+    constexpr NativeFunction FUNCTIONS[] = {
+        {"address",    VMemNative::address,   VARIADIC},
+        {"usage",      VMemNative::usage,     VARIADIC},
+        bind<&VMemNative::memoStats>("memo_stats"),
+    };
+}
 
-    // vmem properties
-}
\ No newline at end of file
+const NativeModule VMEM_MODULE = {
+    "vmem",
+    FUNCTIONS, std::size(FUNCTIONS),
+    nullptr, 0,
+    nullptr,
+};
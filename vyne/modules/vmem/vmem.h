@@ -9,5 +9,7 @@
 
 #include "../../compiler/ast/ast.h"
 #include "../../compiler/ast/value.h"
+#include "../registry.h"
+#include "../bind.h"
 
-void setupVMem(SymbolContainer& env, StringPool& pool);
\ No newline at end of file
+extern const NativeModule VMEM_MODULE;
\ No newline at end of file
@@ -59,7 +59,7 @@ InterpretResult VM::run() {
 
             case OP_DEFINE_GLOBAL : {
                 Value nameValue = READ_CONSTANT();
-                std::string name = *std::get<std::shared_ptr<std::string>>(nameValue.data);
+                const std::string& name = nameValue.asString();
 
                 Value val = pop();
 
@@ -69,7 +69,7 @@ InterpretResult VM::run() {
             }
             case OP_GET_GLOBAL: {
                 Value nameValue = READ_CONSTANT();
-                std::string name = *std::get<std::shared_ptr<std::string>>(nameValue.data);
+                const std::string& name = nameValue.asString();
 
                 uint32_t nameId = StringPool::intern(name);
 
@@ -16,7 +16,7 @@ class VM {
     uint8_t* ip;
     std::vector<Value> stack;
     SymbolContainer& globals; 
-    std::string currentGroup = "global";
+    ScopeId currentGroup = SymbolContainer::GLOBAL;
 
 public:
     VM(SymbolContainer& env) : chunk(nullptr), ip(nullptr), globals(env) {}